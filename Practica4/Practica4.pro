@@ -1,13 +1,68 @@
 TEMPLATE = app
 CONFIG += console c++17
 CONFIG -= app_bundle
-CONFIG += qt
+CONFIG -= qt
+CONFIG += thread
+
+# SIMD (AVX2/SSE4.1 según la CPU) para el Floyd–Warshall por bloques. El
+# ejecutable queda atado a la CPU donde se compila, así que es opcional:
+# qmake "CONFIG += nativo"
+nativo {
+    *-g++*|*-clang*: QMAKE_CXXFLAGS += -march=native
+}
+
+# Instrumentación (contadores y tiempos por fase, ver instrumentacion.h).
+# Para compilarla fuera: qmake "DEFINES += SIN_INSTRUMENTACION"
+# DEFINES += SIN_INSTRUMENTACION
 
 SOURCES += \
         enrutador.cpp \
         main.cpp \
-        red.cpp
+        red.cpp \
+        grafocsr.cpp \
+        poolhilos.cpp \
+        todospares.cpp \
+        floydwarshall.cpp \
+        cacherutas.cpp \
+        bidireccional.cpp \
+        formatobinario.cpp \
+        cargadortexto.cpp \
+        lote.cpp \
+        generadores.cpp \
+        vectordistancia.cpp \
+        colacalendario.cpp \
+        estadoenlace.cpp \
+        reenvio.cpp \
+        exportacion.cpp \
+        instrumentacion.cpp \
+        versiones.cpp \
+        jerarquia.cpp \
+        matrizcostos.cpp \
+        catalogo.cpp \
+        servidor.cpp
 
 HEADERS += \
     enrutador.h \
-    red.h
+    red.h \
+    grafocsr.h \
+    poolhilos.h \
+    todospares.h \
+    floydwarshall.h \
+    cacherutas.h \
+    bidireccional.h \
+    formatobinario.h \
+    cargadortexto.h \
+    lote.h \
+    generadores.h \
+    vectordistancia.h \
+    colacalendario.h \
+    estadoenlace.h \
+    reenvio.h \
+    exportacion.h \
+    instrumentacion.h \
+    versiones.h \
+    jerarquia.h \
+    matrizcostos.h \
+    catalogo.h \
+    servidor.h \
+    protocolo.h
@@ -0,0 +1,62 @@
+TEMPLATE = app
+TARGET = benchmark
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+CONFIG += thread
+
+# Igual que Practica4.pro: -march=native solo con qmake "CONFIG += nativo"
+nativo {
+    *-g++*|*-clang*: QMAKE_CXXFLAGS += -march=native
+}
+
+# Instrumentación (contadores y tiempos por fase, ver instrumentacion.h).
+# Para compilarla fuera: qmake "DEFINES += SIN_INSTRUMENTACION"
+# DEFINES += SIN_INSTRUMENTACION
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        main.cpp \
+        ../enrutador.cpp \
+        ../red.cpp \
+        ../grafocsr.cpp \
+        ../poolhilos.cpp \
+        ../todospares.cpp \
+        ../floydwarshall.cpp \
+        ../cacherutas.cpp \
+        ../bidireccional.cpp \
+        ../formatobinario.cpp \
+        ../cargadortexto.cpp \
+        ../generadores.cpp \
+        ../vectordistancia.cpp \
+        ../colacalendario.cpp \
+        ../estadoenlace.cpp \
+        ../reenvio.cpp \
+        ../exportacion.cpp \
+        ../instrumentacion.cpp \
+        ../versiones.cpp \
+        ../jerarquia.cpp \
+        ../matrizcostos.cpp
+
+HEADERS += \
+    ../enrutador.h \
+    ../red.h \
+    ../grafocsr.h \
+    ../poolhilos.h \
+    ../todospares.h \
+    ../floydwarshall.h \
+    ../cacherutas.h \
+    ../bidireccional.h \
+    ../formatobinario.h \
+    ../cargadortexto.h \
+    ../generadores.h \
+    ../vectordistancia.h \
+    ../colacalendario.h \
+    ../estadoenlace.h \
+    ../reenvio.h \
+    ../exportacion.h \
+    ../instrumentacion.h \
+    ../versiones.h \
+    ../jerarquia.h \
+    ../matrizcostos.h
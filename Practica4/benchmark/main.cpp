@@ -0,0 +1,337 @@
+#include "red.h"
+#include "grafocsr.h"
+#include "bidireccional.h"
+#include "reenvio.h"
+#include "versiones.h"
+#include "jerarquia.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define RSS_GETRUSAGE
+#endif
+
+using namespace std;
+
+// ============================
+// Utilidades de medición
+// ============================
+
+// Descarta todo lo que se escribe
+class FlujoNulo : public streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    streamsize xsputn(const char*, streamsize n) override { return n; }
+};
+
+/**
+ * @brief Pico de memoria residente del proceso en KiB (0 si no se puede medir).
+ */
+static long picoRSS() {
+#ifdef RSS_GETRUSAGE
+    rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+#ifdef __APPLE__
+    return uso.ru_maxrss / 1024; // macOS lo da en bytes
+#else
+    return uso.ru_maxrss;
+#endif
+#else
+    return 0;
+#endif
+}
+
+struct Caso {
+    string nombre;
+    string unidad;          // qué se cuenta en 'operaciones'
+    double operaciones = 0; // por repetición
+    vector<double> ms;      // una entrada por repetición
+    long rssKB = 0;         // pico del proceso al terminar el caso
+};
+
+static double mediana(vector<double> v) {
+    if (v.empty()) return 0;
+    sort(v.begin(), v.end());
+    size_t m = v.size() / 2;
+    return v.size() % 2 ? v[m] : (v[m - 1] + v[m]) / 2;
+}
+
+/**
+ * @brief Repite 'cuerpo' y guarda el tiempo de cada repetición. 'preparar'
+ * corre antes de cada repetición y no se mide.
+ */
+static Caso medir(const string& nombre, const string& unidad, double operaciones, int repeticiones,
+                  const function<void()>& preparar, const function<void()>& cuerpo) {
+    Caso c{nombre, unidad, operaciones, {}, 0};
+    for (int r = 0; r < repeticiones; ++r) {
+        if (preparar) preparar();
+        auto t0 = chrono::steady_clock::now();
+        cuerpo();
+        auto t1 = chrono::steady_clock::now();
+        c.ms.push_back(chrono::duration<double, milli>(t1 - t0).count());
+    }
+    c.rssKB = picoRSS();
+    cerr << left << setw(32) << nombre << right << fixed << setprecision(3)
+         << setw(12) << mediana(c.ms) << " ms" << setw(14) << setprecision(0)
+         << (mediana(c.ms) > 0 ? operaciones * 1000 / mediana(c.ms) : 0) << " " << unidad << "/s"
+         << setw(10) << c.rssKB << " KiB\n";
+    return c;
+}
+
+static void escribirJSON(ostream& out, const vector<Caso>& casos, int n, double densidad,
+                         int repeticiones, int consultas, int hilos) {
+    out << fixed << setprecision(4);
+    out << "{\n";
+    out << "  \"nodos\": " << n << ",\n";
+    out << "  \"densidad\": " << densidad << ",\n";
+    out << "  \"repeticiones\": " << repeticiones << ",\n";
+    out << "  \"consultas\": " << consultas << ",\n";
+    out << "  \"hilos\": " << hilos << ",\n";
+    out << "  \"rss_pico_kb\": " << picoRSS() << ",\n";
+    out << "  \"casos\": [\n";
+    for (size_t i = 0; i < casos.size(); ++i) {
+        const Caso& c = casos[i];
+        double med = mediana(c.ms);
+        out << "    {\"nombre\": \"" << c.nombre << "\""
+            << ", \"mediana_ms\": " << med
+            << ", \"min_ms\": " << *min_element(c.ms.begin(), c.ms.end())
+            << ", \"max_ms\": " << *max_element(c.ms.begin(), c.ms.end())
+            << ", \"operaciones\": " << setprecision(0) << c.operaciones
+            << ", \"unidad\": \"" << c.unidad << "\""
+            << ", \"por_segundo\": " << (med > 0 ? c.operaciones * 1000 / med : 0) << setprecision(4)
+            << ", \"rss_pico_kb\": " << c.rssKB << "}"
+            << (i + 1 < casos.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+// ============================
+// Redes sintéticas
+// ============================
+
+/**
+ * @brief Red con cada par conectado con probabilidad 'densidad' y costos en [1, 20]
+ * (los mismos que usa generarRedAleatoria). Devuelve la cantidad de enlaces.
+ */
+static long long generarRed(Red& red, int n, double densidad, unsigned semilla) {
+    mt19937 rng(semilla);
+    bernoulli_distribution hayEnlace(densidad);
+    uniform_int_distribution<int> costo(1, 20);
+    long long enlaces = 0;
+    for (int i = 1; i <= n; ++i)
+        for (int j = i + 1; j <= n; ++j)
+            if (hayEnlace(rng)) {
+                red.conectar(i, j, costo(rng));
+                ++enlaces;
+            }
+    return enlaces;
+}
+
+int main(int argc, char *argv[]) {
+    // Uso: benchmark [--nodos N] [--densidad D] [--repeticiones R]
+    //                [--consultas Q] [--hilos H] [--json archivo]
+    int n = 500;
+    double densidad = 0.1;
+    int repeticiones = 5;
+    int consultas = 2000;
+    int hilos = 0;
+    string rutaJSON;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--nodos") n = atoi(argv[i + 1]);
+        else if (opcion == "--densidad") densidad = atof(argv[i + 1]);
+        else if (opcion == "--repeticiones") repeticiones = atoi(argv[i + 1]);
+        else if (opcion == "--consultas") consultas = atoi(argv[i + 1]);
+        else if (opcion == "--hilos") hilos = atoi(argv[i + 1]);
+        else if (opcion == "--json") rutaJSON = argv[i + 1];
+        else { cerr << "Opción desconocida: " << opcion << "\n"; return 1; }
+    }
+    if (n < 2 || repeticiones < 1 || densidad < 0 || densidad > 1) {
+        cerr << "Parámetros inválidos.\n";
+        return 1;
+    }
+
+    // Los archivos de prueba quedan en un directorio temporal propio
+    namespace fs = std::filesystem;
+    fs::path original = fs::current_path();
+    fs::path trabajo = fs::temp_directory_path() /
+        ("benchmark_practica4_" + to_string(chrono::steady_clock::now().time_since_epoch().count()));
+    fs::create_directories(trabajo);
+    fs::current_path(trabajo);
+    const string texto = "red.txt", binario = "red.bin";
+
+    // Las funciones de Red imprimen sus resultados: la salida estándar se
+    // descarta hasta escribir el JSON
+    FlujoNulo nulo;
+    streambuf* salidaReal = cout.rdbuf(&nulo);
+
+    cerr << "nodos=" << n << " densidad=" << densidad << " repeticiones=" << repeticiones
+         << " consultas=" << consultas << "\n\n";
+
+    vector<Caso> casos;
+    double paresCompletos = (double)n * (n - 1) / 2;
+    double pares = (double)n * n;
+
+    // --- Generación (red completa) ---
+    unique_ptr<Red> completa;
+    casos.push_back(medir("generarRedAleatoria", "enlaces", paresCompletos, repeticiones,
+        [&] { completa = make_unique<Red>(n); },
+        [&] { completa->generarRedAleatoria(); }));
+    completa.reset();
+
+    // --- Red de trabajo con la densidad pedida ---
+    Red red(n);
+    long long enlaces = generarRed(red, n, densidad, 42);
+    red.guardarBinario(binario);
+
+    // --- Guardado y carga ---
+    casos.push_back(medir("guardarEnArchivo", "enlaces", enlaces, repeticiones, nullptr,
+        [&] { red.guardarEnArchivo(texto); }));
+    casos.push_back(medir("cargarDesdeArchivo", "enlaces", enlaces, repeticiones, nullptr,
+        [&] { Red r; r.cargarDesdeArchivo(texto); }));
+    casos.push_back(medir("guardarBinario", "enlaces", enlaces, repeticiones, nullptr,
+        [&] { red.guardarBinario(binario); }));
+    casos.push_back(medir("cargarBinario", "enlaces", enlaces, repeticiones, nullptr,
+        [&] { Red r; r.cargarBinario(binario); }));
+
+    // Cada repetición de los casos de rutas parte de una red recién cargada,
+    // sin tablas en caché
+    unique_ptr<Red> fresca;
+    auto recargar = [&] { fresca = make_unique<Red>(); fresca->setHilos(hilos); fresca->cargarBinario(binario); };
+
+    mt19937 rng(3);
+    uniform_int_distribution<int> id(1, n);
+    vector<pair<int,int>> paresConsulta(consultas);
+    for (auto& p : paresConsulta) p = {id(rng), id(rng)};
+
+    // --- Rutas ---
+    casos.push_back(medir("calcularRutaMasCorta", "consultas", consultas, repeticiones, recargar,
+        [&] { for (auto [o, d] : paresConsulta) fresca->calcularRutaMasCorta(o, d); }));
+    casos.push_back(medir("mostrarRed", "pares", pares, repeticiones, recargar,
+        [&] { fresca->mostrarRed(); }));
+    casos.push_back(medir("mostrarTablasDeEnrutamiento", "pares", pares, repeticiones, recargar,
+        [&] { fresca->mostrarTablasDeEnrutamiento(); }));
+
+    // --- Ediciones con las tablas en caché: una por una (cada una repara la
+    // caché) o todas en un lote (una sola reconstrucción) ---
+    const int EDICIONES_LOTE = 200;
+    vector<Edicion> lote;
+    mt19937 rngLote(11);
+    for (int k = 0; k < EDICIONES_LOTE; ++k) {
+        int a = id(rngLote), b = id(rngLote);
+        if (a != b) lote.push_back({TipoEdicion::Conectar, a, b, 1 + (int)(rngLote() % 20)});
+    }
+    auto recargarConTablas = [&] { recargar(); fresca->mostrarTablasDeEnrutamiento(); };
+    casos.push_back(medir("conectarUnoPorUno", "ediciones", lote.size(), repeticiones, recargarConTablas,
+        [&] { for (const Edicion& e : lote) fresca->conectar(e.id1, e.id2, e.costo); }));
+    casos.push_back(medir("aplicarEdiciones", "ediciones", lote.size(), repeticiones, recargarConTablas,
+        [&] { fresca->aplicarEdiciones(lote); }));
+
+    // --- Lectores concurrentes con ediciones ---
+    // Cada lector fija la versión vigente para cada consulta mientras el
+    // hilo principal edita enlaces y publica versiones nuevas sin esperarlos
+    int lectores = max(2, hilos > 0 ? hilos : (int)thread::hardware_concurrency());
+    long long ediciones = 0;
+    casos.push_back(medir("consultasConEdiciones", "consultas", consultas, repeticiones, recargar, [&] {
+        atomic<int> terminados{0};
+        vector<thread> hilosLectores;
+        for (int t = 0; t < lectores; ++t)
+            hilosLectores.emplace_back([&, t] {
+                vector<int> caminoIds;
+                for (int q = t; q < consultas; q += lectores) {
+                    VersionFijada v = fresca->fijarVersion();
+                    rutaEnVersion(*v, paresConsulta[q].first, paresConsulta[q].second, caminoIds);
+                }
+                ++terminados;
+            });
+        mt19937 rngEdicion(7);
+        while (terminados.load() < lectores) {
+            int a = id(rngEdicion), b = id(rngEdicion);
+            if (a != b) fresca->conectar(a, b, 1 + (int)(rngEdicion() % 20));
+            fresca->fijarVersion();
+            ++ediciones;
+        }
+        for (auto& h : hilosLectores) h.join();
+    }));
+    cerr << "  (" << lectores << " lectores, " << ediciones << " ediciones publicadas)\n";
+
+    // --- Núcleos de Dijkstra sobre la instantánea ---
+    const GrafoCSR& g = red.instantanea();
+    vector<int> dist(n), prev(n), camino;
+    EspacioDijkstra espacio;
+    EspacioBidireccional espacioBi;
+    int fuentes = min(n, 200);
+    long long controlA = 0, controlB = 0;
+
+    casos.push_back(medir("dijkstraMonticulo", "arboles", fuentes, repeticiones, nullptr, [&] {
+        for (int s = 0; s < fuentes; ++s) {
+            dijkstraMonticulo(g, (int)((long long)s * n / fuentes), dist.data(), prev.data(), espacio);
+            controlA += dist[n - 1] == INFINITO ? -1 : dist[n - 1];
+        }
+    }));
+    casos.push_back(medir("dijkstraCubetas", "arboles", fuentes, repeticiones, nullptr, [&] {
+        for (int s = 0; s < fuentes; ++s) {
+            dijkstraCubetas(g, (int)((long long)s * n / fuentes), dist.data(), prev.data(), espacio);
+            controlB += dist[n - 1] == INFINITO ? -1 : dist[n - 1];
+        }
+    }));
+    casos.push_back(medir("rutaBidireccional", "consultas", consultas, repeticiones, nullptr, [&] {
+        for (auto [o, d] : paresConsulta) rutaBidireccional(g, o - 1, d - 1, camino, espacioBi);
+    }));
+
+    // --- Jerarquía de contracción (las redes aleatorias densas suelen no tenerla) ---
+    JerarquiaContraccion jerarquia;
+    bool conJerarquia = false;
+    casos.push_back(medir("construirJerarquia", "redes", 1, repeticiones, nullptr,
+        [&] { conJerarquia = jerarquia.construir(g); }));
+    if (conJerarquia) {
+        EspacioJerarquia espacioCH;
+        casos.push_back(medir("rutaJerarquia", "consultas", consultas, repeticiones, nullptr, [&] {
+            for (auto [o, d] : paresConsulta) jerarquia.ruta(o - 1, d - 1, camino, espacioCH);
+        }));
+    } else {
+        cerr << "  (la red no tiene una jerarquía de contracción aprovechable)\n";
+    }
+
+    // --- Plano de datos: FIB y reenvío de paquetes ---
+    PoolHilos poolFIB(hilos);
+    TablaReenvio fib;
+    casos.push_back(medir("construirFIB", "arboles", n, repeticiones, nullptr,
+        [&] { fib.construir(g, poolFIB); }));
+    ConfiguracionTrafico trafico;
+    trafico.paquetes = 1000000;
+    casos.push_back(medir("reenvioPaquetes", "paquetes", trafico.paquetes, repeticiones, nullptr,
+        [&] { simularTrafico(fib, trafico, poolFIB); }));
+
+    cout.rdbuf(salidaReal);
+    fs::current_path(original);
+    fs::remove_all(trabajo);
+
+    if (controlA != controlB) {
+        cerr << "Los núcleos de Dijkstra dieron distancias distintas\n";
+        return 1;
+    }
+
+    if (rutaJSON.empty()) {
+        escribirJSON(cout, casos, n, densidad, repeticiones, consultas, hilos);
+    } else {
+        ofstream archivo(rutaJSON);
+        if (!archivo) {
+            cerr << "No se pudo crear " << rutaJSON << "\n";
+            return 1;
+        }
+        escribirJSON(archivo, casos, n, densidad, repeticiones, consultas, hilos);
+    }
+    return 0;
+}
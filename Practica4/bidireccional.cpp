@@ -0,0 +1,97 @@
+#include "bidireccional.h"
+#include "instrumentacion.h"
+#include <algorithm>
+using namespace std;
+
+int rutaBidireccional(const GrafoCSR& g, int origen, int destino,
+                      vector<int>& camino, EspacioBidireccional& e) {
+    int n = g.cantidadNodos();
+    camino.clear();
+    if (origen < 0 || destino < 0 || origen >= n || destino >= n) return INFINITO;
+    if (origen == destino) {
+        camino.push_back(origen);
+        return 0;
+    }
+
+    for (int lado = 0; lado < 2; ++lado) {
+        if ((int)e.dist[lado].size() != n) {
+            e.dist[lado].assign(n, INFINITO);
+            e.prev[lado].assign(n, -1);
+            e.asentado[lado].assign(n, 0);
+        }
+        e.monticulo[lado].clear();
+    }
+    e.tocados.clear();
+
+    greater<pair<int,int>> cmp;
+    ConteoRecorrido conteo;
+    CONTAR(EJECUCIONES_DIJKSTRA, 1);
+    auto tocar = [&](int lado, int v, int d, int p) {
+        if (e.dist[0][v] == INFINITO && e.dist[1][v] == INFINITO) e.tocados.push_back(v);
+        e.dist[lado][v] = d;
+        e.prev[lado][v] = p;
+        e.monticulo[lado].push_back({d, v});
+        push_heap(e.monticulo[lado].begin(), e.monticulo[lado].end(), cmp);
+        ++conteo.inserciones;
+    };
+    tocar(0, origen, 0, -1);
+    tocar(1, destino, 0, -1);
+
+    const int extremo[2] = {destino, origen};
+    int mejor = INFINITO;
+    int encuentro = -1; // nodo donde se unen las dos mitades del mejor camino
+
+    while (!e.monticulo[0].empty() && !e.monticulo[1].empty()) {
+        int tope0 = e.monticulo[0].front().first;
+        int tope1 = e.monticulo[1].front().first;
+        if (mejor != INFINITO && (long long)tope0 + tope1 >= mejor) break;
+
+        // Se expande la frontera con el menor tope
+        int lado = tope0 <= tope1 ? 0 : 1;
+        auto& pq = e.monticulo[lado];
+        pop_heap(pq.begin(), pq.end(), cmp);
+        auto [d, u] = pq.back(); pq.pop_back();
+        ++conteo.extracciones;
+        if (d > e.dist[lado][u] || e.asentado[lado][u]) {
+            ++conteo.viejas;
+            continue;
+        }
+        e.asentado[lado][u] = 1;
+
+        // Salida temprana: esta búsqueda asentó el extremo opuesto
+        if (u == extremo[lado]) {
+            mejor = d;
+            encuentro = u;
+            break;
+        }
+
+        const auto& otra = e.dist[1 - lado];
+        conteo.relajaciones += g.inicio[u + 1] - g.inicio[u];
+        for (int k = g.inicio[u]; k < g.inicio[u + 1]; ++k) {
+            int v = g.destino[k];
+            int nd = d + g.costo[k];
+            if (nd < e.dist[lado][v]) tocar(lado, v, nd, u);
+            if (nd <= e.dist[lado][v] && otra[v] != INFINITO && (long long)nd + otra[v] < mejor) {
+                mejor = nd + otra[v];
+                encuentro = v;
+            }
+        }
+    }
+
+    if (encuentro != -1) {
+        // Mitad hacia adelante (origen -> encuentro) y mitad hacia atrás (encuentro -> destino)
+        for (int x = encuentro; x != -1; x = e.prev[0][x]) camino.push_back(x);
+        reverse(camino.begin(), camino.end());
+        for (int x = e.prev[1][encuentro]; x != -1; x = e.prev[1][x]) camino.push_back(x);
+    }
+
+    // Dejar la memoria de trabajo lista para la próxima consulta
+    for (int v : e.tocados) {
+        for (int lado = 0; lado < 2; ++lado) {
+            e.dist[lado][v] = INFINITO;
+            e.prev[lado][v] = -1;
+            e.asentado[lado][v] = 0;
+        }
+    }
+    return encuentro == -1 ? INFINITO : mejor;
+}
@@ -0,0 +1,30 @@
+#ifndef BIDIRECCIONAL_H
+#define BIDIRECCIONAL_H
+
+#include "grafocsr.h"
+#include <vector>
+
+// ===========================
+// Ruta punto a punto bidireccional
+// ===========================
+// Dijkstra simultáneo desde el origen y desde el destino (la red es no
+// dirigida, así que ambos usan la misma adyacencia). Termina en cuanto la
+// suma de los mínimos de ambas fronteras alcanza el mejor camino visto, o
+// cuando una búsqueda asienta el extremo de la otra.
+//
+// La memoria de trabajo se reinicia recorriendo solo los nodos tocados, así
+// que una consulta cercana no paga O(n) aunque la red sea grande.
+struct EspacioBidireccional {
+    std::vector<int> dist[2];
+    std::vector<int> prev[2];
+    std::vector<char> asentado[2];
+    std::vector<std::pair<int,int>> monticulo[2];
+    std::vector<int> tocados;
+};
+
+// Devuelve el costo mínimo (INFINITO si no hay ruta) y deja en 'camino'
+// los índices origen -> ... -> destino.
+int rutaBidireccional(const GrafoCSR& grafo, int origen, int destino,
+                      std::vector<int>& camino, EspacioBidireccional& espacio);
+
+#endif // BIDIRECCIONAL_H
@@ -0,0 +1,247 @@
+#include "cacherutas.h"
+#include "instrumentacion.h"
+#include <algorithm>
+using namespace std;
+
+// ============================
+// Cálculo completo
+// ============================
+void CacheRutas::invalidar() {
+    esValida = false;
+    m = MatrizTodosLosPares();
+}
+
+void CacheRutas::recalcular(GrafoCSR grafo, PoolHilos& pool) {
+    g = move(grafo);
+    calcularTodosLosPares(g, pool, m, true);
+    esValida = true;
+}
+
+// ============================
+// Reparaciones sobre una fila
+// ============================
+
+// Dijkstra que parte de los nodos ya mejorados en e.monticulo y solo
+// avanza mientras encuentre distancias estrictamente menores
+template <typename P>
+void CacheRutas::propagarMejora(int* dist, P* prev, Espacio& e) const {
+    greater<pair<int,int>> cmp;
+    auto& pq = e.monticulo;
+    ConteoRecorrido conteo;
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), cmp);
+        auto [d, x] = pq.back(); pq.pop_back();
+        ++conteo.extracciones;
+        if (d > dist[x]) {
+            ++conteo.viejas;
+            continue;
+        }
+        conteo.relajaciones += g.inicio[x + 1] - g.inicio[x];
+        for (int k = g.inicio[x]; k < g.inicio[x + 1]; ++k) {
+            int z = g.destino[k];
+            int nd = d + g.costo[k];
+            if (nd < dist[z]) {
+                dist[z] = nd;
+                prev[z] = x;
+                pq.push_back({nd, z});
+                push_heap(pq.begin(), pq.end(), cmp);
+                ++conteo.inserciones;
+            }
+        }
+    }
+}
+
+// El enlace u - v bajó de costo (o es nuevo): solo cambia algo si acorta
+// el camino hacia alguno de sus extremos
+template <typename P>
+void CacheRutas::repararDisminucion(int* dist, P* prev, int u, int v, int costo, Espacio& e) const {
+    greater<pair<int,int>> cmp;
+    e.monticulo.clear();
+    auto probar = [&](int a, int b) {
+        if (dist[a] != INFINITO && dist[a] + costo < dist[b]) {
+            dist[b] = dist[a] + costo;
+            prev[b] = a;
+            e.monticulo.push_back({dist[b], b});
+            push_heap(e.monticulo.begin(), e.monticulo.end(), cmp);
+            CONTAR(INSERCIONES_COLA, 1);
+        }
+    };
+    probar(u, v);
+    probar(v, u);
+    propagarMejora(dist, prev, e);
+}
+
+// Los subárboles que cuelgan de e.raices perdieron su camino: se marcan,
+// se reinician y se recalculan a partir de sus vecinos no afectados
+template <typename P>
+void CacheRutas::repararSubarboles(int* dist, P* prev, Espacio& e) const {
+    int n = g.cantidadNodos();
+    const char DESCONOCIDO = 0, DENTRO = 1, FUERA = 2;
+
+    e.estado.assign(n, DESCONOCIDO);
+    e.subarbol.clear();
+    for (int r : e.raices) {
+        e.estado[r] = DENTRO;
+        e.subarbol.push_back(r);
+    }
+
+    // Clasificar cada nodo subiendo por su cadena de predecesores
+    for (int j = 0; j < n; ++j) {
+        if (e.estado[j] != DESCONOCIDO) continue;
+        e.pila.clear();
+        int x = j;
+        char resultado = FUERA; // el origen y los inalcanzables no cuelgan de ninguna raíz
+        while (true) {
+            if (e.estado[x] != DESCONOCIDO) { resultado = e.estado[x]; break; }
+            e.pila.push_back(x);
+            if (prev[x] == sinPredecesor<P>()) break;
+            x = prev[x];
+        }
+        for (int y : e.pila) {
+            e.estado[y] = resultado;
+            if (resultado == DENTRO) e.subarbol.push_back(y);
+        }
+    }
+
+    for (int x : e.subarbol) {
+        dist[x] = INFINITO;
+        prev[x] = sinPredecesor<P>();
+    }
+
+    // Mejor entrada desde la frontera (el grafo es no dirigido)
+    greater<pair<int,int>> cmp;
+    auto& pq = e.monticulo;
+    pq.clear();
+    for (int x : e.subarbol) {
+        for (int k = g.inicio[x]; k < g.inicio[x + 1]; ++k) {
+            int y = g.destino[k];
+            if (e.estado[y] != FUERA || dist[y] == INFINITO) continue;
+            if (dist[y] + g.costo[k] < dist[x]) {
+                dist[x] = dist[y] + g.costo[k];
+                prev[x] = y;
+            }
+        }
+        if (dist[x] != INFINITO) pq.push_back({dist[x], x});
+    }
+    make_heap(pq.begin(), pq.end(), cmp);
+    ConteoRecorrido conteo;
+    conteo.inserciones = pq.size();
+
+    // Dijkstra restringido al subárbol
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), cmp);
+        auto [d, x] = pq.back(); pq.pop_back();
+        ++conteo.extracciones;
+        if (d > dist[x]) {
+            ++conteo.viejas;
+            continue;
+        }
+        conteo.relajaciones += g.inicio[x + 1] - g.inicio[x];
+        for (int k = g.inicio[x]; k < g.inicio[x + 1]; ++k) {
+            int z = g.destino[k];
+            if (e.estado[z] != DENTRO) continue;
+            int nd = d + g.costo[k];
+            if (nd < dist[z]) {
+                dist[z] = nd;
+                prev[z] = x;
+                pq.push_back({nd, z});
+                push_heap(pq.begin(), pq.end(), cmp);
+                ++conteo.inserciones;
+            }
+        }
+    }
+}
+
+// ============================
+// Ediciones de la red
+// ============================
+void CacheRutas::enlaceCambiado(GrafoCSR grafo, int u, int v, int costoAnterior, int costoNuevo, PoolHilos& pool) {
+    g = move(grafo);
+    if (!esValida || costoAnterior == costoNuevo) return;
+    MEDIR_FASE(FASE_REPARACION);
+    if (m.prev16.empty()) repararEnlace<int>(u, v, costoAnterior, costoNuevo, pool);
+    else repararEnlace<uint16_t>(u, v, costoAnterior, costoNuevo, pool);
+}
+
+template <typename P>
+void CacheRutas::repararEnlace(int u, int v, int costoAnterior, int costoNuevo, PoolHilos& pool) {
+    int n = m.n;
+    vector<Espacio> espacios(pool.cantidadHilos());
+
+    pool.paraCada(n, [&](int s, int hilo) {
+        int* dist = m.filaDist(s);
+        P* prev = m.filaPrev<P>(s);
+        Espacio& e = espacios[hilo];
+
+        if (costoNuevo < costoAnterior) {
+            repararDisminucion(dist, prev, u, v, costoNuevo, e);
+            return;
+        }
+        // Un aumento solo afecta a los orígenes cuyo árbol usa el enlace
+        e.raices.clear();
+        if (prev[v] == u) e.raices.push_back(v);
+        else if (prev[u] == v) e.raices.push_back(u);
+        if (!e.raices.empty()) repararSubarboles(dist, prev, e);
+    });
+}
+
+void CacheRutas::enrutadorAgregado(GrafoCSR grafo) {
+    g = move(grafo);
+    if (!esValida) return;
+    MEDIR_FASE(FASE_REPARACION);
+
+    // Con 65535 nodos los predecesores pasan a 4 bytes: las filas se copian como int
+    int n = m.n, nn = n + 1;
+    MatrizTodosLosPares nueva;
+    nueva.dimensionar(nn, true);
+    vector<int> fila(nn, -1);
+    for (int i = 0; i < n; ++i) {
+        copy(m.filaDist(i), m.filaDist(i) + n, nueva.filaDist(i));
+        m.copiarFilaPrev(i, fila.data());
+        nueva.asignarFilaPrev(i, fila.data());
+    }
+    nueva.dist[(size_t)n * nn + n] = 0;
+    m = move(nueva);
+}
+
+void CacheRutas::enrutadorEliminado(GrafoCSR grafo, int x, PoolHilos& pool) {
+    g = move(grafo);
+    if (!esValida) return;
+    MEDIR_FASE(FASE_REPARACION);
+
+    int n = m.n, nn = n - 1;
+    MatrizTodosLosPares nueva;
+    nueva.dimensionar(nn, true);
+    vector<Espacio> espacios(pool.cantidadHilos());
+
+    // Cada fila se compacta (sin la fila/columna x, índices corridos) y los
+    // nodos que colgaban directamente de x pasan a ser raíces a reparar. La
+    // fila se arma como int y se guarda en el ancho de la matriz nueva
+    pool.paraCada(nn, [&](int s, int hilo) {
+        const int* distViejo = m.filaDist(s + (s >= x));
+        int* dist = nueva.filaDist(s);
+        Espacio& e = espacios[hilo];
+        e.filaVieja.resize(n);
+        e.filaNueva.resize(nn);
+        m.copiarFilaPrev(s + (s >= x), e.filaVieja.data());
+        const int* prevViejo = e.filaVieja.data();
+        int* prev = e.filaNueva.data();
+        e.raices.clear();
+
+        for (int j = 0; j < nn; ++j) {
+            int jv = j + (j >= x);
+            int p = prevViejo[jv];
+            dist[j] = distViejo[jv];
+            if (p == x) {
+                prev[j] = -1;
+                e.raices.push_back(j);
+            } else {
+                prev[j] = (p > x) ? p - 1 : p;
+            }
+        }
+        if (!e.raices.empty()) repararSubarboles(dist, prev, e);
+        nueva.asignarFilaPrev(s, prev);
+    });
+
+    m = move(nueva);
+}
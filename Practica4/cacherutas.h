@@ -0,0 +1,60 @@
+#ifndef CACHERUTAS_H
+#define CACHERUTAS_H
+
+#include "grafocsr.h"
+#include "todospares.h"
+#include "poolhilos.h"
+#include <vector>
+
+// ===========================
+// Árboles de rutas más cortas en caché
+// ===========================
+// Guarda, para cada origen, la distancia y el predecesor hacia todos los
+// destinos (un árbol de rutas más cortas por fila). Tras cada edición de la
+// red solo se reparan las filas y subárboles afectados en lugar de repetir
+// los n Dijkstra. Los métodos de edición reciben la instantánea CSR que ya
+// incluye el cambio.
+class CacheRutas {
+public:
+    bool valida() const { return esValida; }
+    void invalidar();
+
+    const GrafoCSR& grafo() const { return g; }
+    const MatrizTodosLosPares& tablas() const { return m; }
+
+    // Cálculo completo (un Dijkstra por origen)
+    void recalcular(GrafoCSR grafo, PoolHilos& pool);
+
+    // El enlace u - v pasó de costoAnterior a costoNuevo (INFINITO = sin enlace)
+    void enlaceCambiado(GrafoCSR grafo, int u, int v, int costoAnterior, int costoNuevo, PoolHilos& pool);
+
+    // Se agregó un enrutador aislado al final
+    void enrutadorAgregado(GrafoCSR grafo);
+
+    // Se eliminó el enrutador que ocupaba la posición 'indice'; grafo ya está renumerado
+    void enrutadorEliminado(GrafoCSR grafo, int indice, PoolHilos& pool);
+
+private:
+    // Memoria de trabajo de una reparación (una por hilo)
+    struct Espacio {
+        std::vector<std::pair<int,int>> monticulo;
+        std::vector<char> estado;
+        std::vector<int> pila;
+        std::vector<int> subarbol;
+        std::vector<int> raices;
+        std::vector<int> filaVieja, filaNueva; // predecesores como int al renumerar
+    };
+
+    // Operan sobre una fila (dist, prev) usando la instantánea actual; P es
+    // el tipo de los predecesores de la matriz (uint16_t o int)
+    template <typename P> void propagarMejora(int* dist, P* prev, Espacio& e) const;
+    template <typename P> void repararDisminucion(int* dist, P* prev, int u, int v, int costo, Espacio& e) const;
+    template <typename P> void repararSubarboles(int* dist, P* prev, Espacio& e) const; // raíces en e.raices
+    template <typename P> void repararEnlace(int u, int v, int costoAnterior, int costoNuevo, PoolHilos& pool);
+
+    bool esValida = false;
+    GrafoCSR g;
+    MatrizTodosLosPares m;
+};
+
+#endif // CACHERUTAS_H
@@ -0,0 +1,200 @@
+#include "cargadortexto.h"
+#include "instrumentacion.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <vector>
+using namespace std;
+
+namespace {
+
+const size_t TAM_BLOQUE = 1 << 22;   // 4 MiB por lectura
+const long long MAX_AVISOS = 10;     // líneas mal formadas que se listan una a una
+
+// Tabla hash de direccionamiento abierto id -> índice denso
+class TablaIds {
+public:
+    TablaIds() { redimensionar(1024); }
+
+    int indice(int id, vector<int>& ids) {
+        if ((cantidad + 1) * 2 > (int)claves.size()) redimensionar(claves.size() * 2);
+        size_t mascara = claves.size() - 1;
+        for (size_t p = mezclar(id) & mascara;; p = (p + 1) & mascara) {
+            if (valores[p] == -1) {
+                claves[p] = id;
+                valores[p] = (int)ids.size();
+                ids.push_back(id);
+                ++cantidad;
+                return valores[p];
+            }
+            if (claves[p] == id) return valores[p];
+        }
+    }
+
+private:
+    static size_t mezclar(int id) {
+        uint64_t x = (uint32_t)id * 0x9E3779B97F4A7C15ull;
+        return (size_t)(x ^ (x >> 29));
+    }
+
+    void redimensionar(size_t tam) {
+        vector<int> viejasClaves = move(claves), viejosValores = move(valores);
+        claves.assign(tam, 0);
+        valores.assign(tam, -1);
+        size_t mascara = tam - 1;
+        for (size_t i = 0; i < viejasClaves.size(); ++i) {
+            if (viejosValores[i] == -1) continue;
+            size_t p = mezclar(viejasClaves[i]) & mascara;
+            while (valores[p] != -1) p = (p + 1) & mascara;
+            claves[p] = viejasClaves[i];
+            valores[p] = viejosValores[i];
+        }
+    }
+
+    vector<int> claves, valores;
+    int cantidad = 0;
+};
+
+inline const char* saltarEspacios(const char* p, const char* fin) {
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+// Lee "R<entero>"; devuelve nullptr si el token no es válido
+inline const char* leerEnrutador(const char* p, const char* fin, int& id) {
+    if (p >= fin || *p != 'R') return nullptr;
+    auto [q, ec] = from_chars(p + 1, fin, id);
+    if (ec != errc() || q == p + 1 || id <= 0) return nullptr;
+    return q;
+}
+
+} // namespace
+
+bool cargarTopologiaTexto(const string& ruta, GrafoCSR& grafo, EstadisticasCarga* estadisticas) {
+    FILE* archivo = fopen(ruta.c_str(), "rb");
+    if (!archivo) {
+        cerr << "No se pudo abrir el archivo: " << ruta << endl;
+        return false;
+    }
+
+    EstadisticasCarga est;
+    TablaIds tabla;
+    vector<int> idsLeidos;                    // id de cada índice, en orden de aparición
+    vector<int> origen, destino, costo;       // enlaces en el orden del archivo
+
+    // Procesa una línea completa [p, fin)
+    auto procesarLinea = [&](const char* p, const char* fin) {
+        ++est.lineas;
+        p = saltarEspacios(p, fin);
+        if (p == fin) return; // línea vacía
+
+        int id1, id2, c;
+        const char* q = leerEnrutador(p, fin, id1);
+        if (q) q = leerEnrutador(saltarEspacios(q, fin), fin, id2);
+        if (q) {
+            const char* r = saltarEspacios(q, fin);
+            auto [s, ec] = from_chars(r, fin, c);
+            q = (ec == errc() && s != r && saltarEspacios(s, fin) == fin) ? s : nullptr;
+        }
+        if (!q) {
+            if (++est.malformadas <= MAX_AVISOS)
+                cerr << ruta << ":" << est.lineas << ": línea mal formada: '"
+                     << string(p, min<size_t>(fin - p, 60)) << "'\n";
+            return;
+        }
+
+        ++est.enlaces;
+        if (id1 == id2) return;
+        origen.push_back(tabla.indice(id1, idsLeidos));
+        destino.push_back(tabla.indice(id2, idsLeidos));
+        costo.push_back(c);
+    };
+
+    // Lectura por bloques; la línea que queda cortada al final de un bloque
+    // se mueve al principio del búfer antes de leer el siguiente
+    vector<char> bufer(TAM_BLOQUE);
+    size_t pendiente = 0;
+    while (true) {
+        if (pendiente == bufer.size()) bufer.resize(bufer.size() * 2); // línea enorme
+        size_t leidos = fread(bufer.data() + pendiente, 1, bufer.size() - pendiente, archivo);
+        est.bytes += leidos;
+        CONTAR(BYTES_LEIDOS, leidos);
+        size_t total = pendiente + leidos;
+        bool ultimo = leidos == 0;
+
+        const char* p = bufer.data();
+        const char* fin = p + total;
+        while (true) {
+            const char* nl = (const char*)memchr(p, '\n', fin - p);
+            if (!nl) break;
+            procesarLinea(p, nl);
+            p = nl + 1;
+        }
+        if (ultimo) {
+            if (p < fin) procesarLinea(p, fin);
+            break;
+        }
+        pendiente = fin - p;
+        memmove(bufer.data(), p, pendiente);
+    }
+    // fread también devuelve 0 ante un error (p. ej. si la ruta es una
+    // carpeta): sin esto la red quedaría truncada sin aviso
+    if (ferror(archivo)) {
+        cerr << "Error al leer el archivo: " << ruta << endl;
+        fclose(archivo);
+        return false;
+    }
+    fclose(archivo);
+
+    if (est.malformadas > MAX_AVISOS)
+        cerr << ruta << ": " << est.malformadas << " líneas mal formadas en total\n";
+
+    // Índices por id creciente; los ids quedan tal como están en el archivo
+    int n = idsLeidos.size();
+    vector<int> orden(n), rango(n);
+    for (int i = 0; i < n; ++i) orden[i] = i;
+    sort(orden.begin(), orden.end(), [&](int a, int b) { return idsLeidos[a] < idsLeidos[b]; });
+    for (int i = 0; i < n; ++i) rango[orden[i]] = i;
+
+    // CSR por conteo de grados; cada enlace se guarda en ambos sentidos
+    ArreglosCSR a;
+    a.ids.resize(n);
+    for (int i = 0; i < n; ++i) a.ids[i] = idsLeidos[orden[i]];
+    a.inicio.assign(n + 1, 0);
+    size_t m = origen.size();
+    for (size_t e = 0; e < m; ++e) {
+        ++a.inicio[rango[origen[e]] + 1];
+        ++a.inicio[rango[destino[e]] + 1];
+    }
+    for (int i = 0; i < n; ++i) a.inicio[i + 1] += a.inicio[i];
+
+    // (vecino, orden en el archivo) para poder quedarse con el último costo
+    vector<pair<int, long long>> entradas(a.inicio[n]);
+    vector<int> pos(a.inicio.begin(), a.inicio.end() - 1);
+    for (size_t e = 0; e < m; ++e) {
+        int u = rango[origen[e]], v = rango[destino[e]];
+        entradas[pos[u]++] = {v, (long long)e};
+        entradas[pos[v]++] = {u, (long long)e};
+    }
+
+    a.destino.reserve(entradas.size());
+    a.costo.reserve(entradas.size());
+    vector<int> nuevoInicio(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        auto ini = entradas.begin() + a.inicio[i], fin = entradas.begin() + a.inicio[i + 1];
+        sort(ini, fin);
+        for (auto it = ini; it != fin; ++it) {
+            if (it + 1 != fin && (it + 1)->first == it->first) continue; // repetido: vale el último
+            a.destino.push_back(it->first);
+            a.costo.push_back(costo[it->second]);
+        }
+        nuevoInicio[i + 1] = a.destino.size();
+    }
+    a.inicio = move(nuevoInicio);
+
+    grafo = empaquetarCSR(move(a));
+    if (estadisticas) *estadisticas = est;
+    return true;
+}
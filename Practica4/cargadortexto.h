@@ -0,0 +1,29 @@
+#ifndef CARGADORTEXTO_H
+#define CARGADORTEXTO_H
+
+#include "grafocsr.h"
+#include <string>
+
+// ===========================
+// Carga por flujo de topologías en texto
+// ===========================
+// Lee archivos con líneas "R<id> R<id> <costo>" (el formato de
+// Red::guardarEnArchivo) por bloques grandes, convierte los números con
+// from_chars y asigna índices con una tabla hash id -> índice mientras
+// lee. Al terminar arma la instantánea CSR con un conteo por grado, sin
+// pasar por objetos Router.
+//
+// Los ids se conservan (los índices siguen el orden creciente de id), se
+// ignoran los enlaces de un enrutador consigo mismo y, si un enlace aparece
+// repetido, vale el último costo. Las líneas mal formadas (incluidos los ids
+// que no son positivos) se informan por cerr con su número y se omiten.
+struct EstadisticasCarga {
+    long long lineas = 0;
+    long long enlaces = 0;       // enlaces leídos (antes de quitar repetidos)
+    long long malformadas = 0;
+    long long bytes = 0;
+};
+
+bool cargarTopologiaTexto(const std::string& ruta, GrafoCSR& grafo, EstadisticasCarga* estadisticas = nullptr);
+
+#endif // CARGADORTEXTO_H
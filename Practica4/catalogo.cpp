@@ -0,0 +1,267 @@
+#include "catalogo.h"
+#include "formatobinario.h"
+#include "cargadortexto.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <cstring>
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* const NOMBRE_INDICE = "catalogo.idx";
+
+// Número de un nombre "red_<número>.txt" (0 si no tiene esa forma)
+static int numeroDeNombre(const string& nombre) {
+    const string prefijo = "red_", sufijo = ".txt";
+    if (nombre.size() <= prefijo.size() + sufijo.size() || nombre.compare(0, prefijo.size(), prefijo) != 0 ||
+        nombre.compare(nombre.size() - sufijo.size(), sufijo.size(), sufijo) != 0)
+        return 0;
+    long numero = 0;
+    for (size_t k = prefijo.size(); k < nombre.size() - sufijo.size(); ++k) {
+        if (nombre[k] < '0' || nombre[k] > '9' || numero > 100000000) return 0;
+        numero = numero * 10 + (nombre[k] - '0');
+    }
+    return (int)numero;
+}
+
+// FNV-1a por palabras de 8 bytes (la cola, de a byte) leyendo por bloques
+static bool sumaArchivo(const string& ruta, uint64_t& suma, uint64_t& bytes) {
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo.is_open()) return false;
+    static thread_local vector<char> bloque(1 << 20);
+    suma = 0xcbf29ce484222325ull;
+    bytes = 0;
+    while (archivo) {
+        archivo.read(bloque.data(), bloque.size());
+        size_t leidos = archivo.gcount(), k = 0;
+        for (; k + 8 <= leidos; k += 8) {
+            uint64_t palabra;
+            memcpy(&palabra, bloque.data() + k, 8);
+            suma = (suma ^ palabra) * 0x100000001b3ull;
+        }
+        for (; k < leidos; ++k) suma = (suma ^ (unsigned char)bloque[k]) * 0x100000001b3ull;
+        bytes += leidos;
+    }
+    return archivo.eof();
+}
+
+// Enrutadores con algún enlace: los que vuelven al leer el archivo
+static int nodosConEnlaces(const GrafoCSR& grafo) {
+    int nodos = 0;
+    for (int i = 0; i < grafo.cantidadNodos(); ++i)
+        if (grafo.inicio[i + 1] > grafo.inicio[i]) ++nodos;
+    return nodos;
+}
+
+// ============================
+// Apertura
+// ============================
+bool CatalogoRedes::abrir(const string& carpetaDatos) {
+    carpeta = carpetaDatos;
+    lista.clear();
+    siguiente = 1;
+
+    error_code ec;
+    fs::create_directories(carpeta, ec);
+    if (ec) {
+        cerr << "No se pudo crear la carpeta: " << carpeta << endl;
+        return false;
+    }
+    string rutaIndice = (fs::path(carpeta) / NOMBRE_INDICE).string();
+    if (fs::exists(rutaIndice, ec)) {
+        if (leer(rutaIndice)) return true;
+        cerr << "Catálogo dañado, se vuelve a armar: " << rutaIndice << endl;
+        lista.clear();
+        siguiente = 1;
+    }
+    reconstruir();
+    return escribir();
+}
+
+bool CatalogoRedes::leer(const string& rutaIndice) {
+    ifstream archivo(rutaIndice, ios::binary);
+    CabeceraCatalogo c{};
+    if (!archivo.read((char*)&c, sizeof(c))) return false;
+    if (memcmp(c.magia, MAGIA_CATALOGO, sizeof(c.magia)) != 0 || c.version != VERSION_CATALOGO ||
+        c.marcaOrden != MARCA_ORDEN || c.bytesNombres > UINT32_MAX)
+        return false;
+
+    // Las cantidades de la cabecera se comparan con el tamaño real antes de
+    // reservar nada: un índice dañado no debe pedir gigas de memoria
+    error_code ec;
+    uint64_t tamano = fs::file_size(rutaIndice, ec);
+    if (ec || tamano != sizeof(c) + sizeof(EntradaCatalogo) * (uint64_t)c.redes + c.bytesNombres)
+        return false;
+
+    vector<EntradaCatalogo> entradas(c.redes);
+    string nombres(c.bytesNombres, '\0');
+    if (!archivo.read((char*)entradas.data(), sizeof(EntradaCatalogo) * entradas.size()) ||
+        !archivo.read(nombres.data(), nombres.size()))
+        return false;
+
+    lista.reserve(entradas.size());
+    for (const EntradaCatalogo& e : entradas) {
+        if ((uint64_t)e.despNombre + e.largoNombre > c.bytesNombres || e.numero == 0 ||
+            e.numero >= c.siguienteNumero || (!lista.empty() && (int)e.numero <= lista.back().numero))
+            return false;
+        RedCatalogada red;
+        red.numero = e.numero;
+        red.nombre = nombres.substr(e.despNombre, e.largoNombre);
+        red.nodos = e.nodos;
+        red.enlaces = e.enlaces;
+        red.suma = e.suma;
+        red.bytes = e.bytes;
+        lista.push_back(move(red));
+    }
+    siguiente = c.siguienteNumero;
+    return true;
+}
+
+// Sin índice (la primera vez, o con carpetas de versiones anteriores) se
+// leen los red_*.txt que haya. Es el único recorrido del directorio
+void CatalogoRedes::reconstruir() {
+    error_code ec;
+    for (const fs::directory_entry& entrada : fs::directory_iterator(carpeta, ec)) {
+        string nombre = entrada.path().filename().string();
+        int numero = numeroDeNombre(nombre);
+        if (numero == 0 || !entrada.is_regular_file(ec)) continue;
+
+        GrafoCSR grafo;
+        RedCatalogada red;
+        if (!cargarTopologiaTexto(entrada.path().string(), grafo) ||
+            !sumaArchivo(entrada.path().string(), red.suma, red.bytes))
+            continue;
+        red.numero = numero;
+        red.nombre = nombre;
+        red.nodos = nodosConEnlaces(grafo);
+        red.enlaces = grafo.destino.size() / 2;
+        lista.push_back(move(red));
+        siguiente = max(siguiente, numero + 1);
+    }
+    sort(lista.begin(), lista.end(), [](const RedCatalogada& a, const RedCatalogada& b) { return a.numero < b.numero; });
+    if (!lista.empty()) cout << "Catálogo armado con " << lista.size() << " redes existentes.\n";
+}
+
+// ============================
+// Consultas
+// ============================
+const RedCatalogada* CatalogoRedes::buscar(int numero) const {
+    auto it = lower_bound(lista.begin(), lista.end(), numero,
+                          [](const RedCatalogada& red, int n) { return red.numero < n; });
+    return it != lista.end() && it->numero == numero ? &*it : nullptr;
+}
+
+string CatalogoRedes::ruta(const RedCatalogada& red) const {
+    return (fs::path(carpeta) / red.nombre).string();
+}
+
+bool CatalogoRedes::verificar(const RedCatalogada& red) const {
+    uint64_t suma, bytes;
+    return sumaArchivo(ruta(red), suma, bytes) && bytes == red.bytes && suma == red.suma;
+}
+
+// Se saltea algún red_<n>.txt copiado a mano después de armar el catálogo
+string CatalogoRedes::rutaNueva() const {
+    error_code ec;
+    for (int numero = siguiente;; ++numero) {
+        fs::path ruta = fs::path(carpeta) / ("red_" + to_string(numero) + ".txt");
+        if (!fs::exists(ruta, ec)) return ruta.string();
+    }
+}
+
+// ============================
+// Actualización
+// ============================
+bool CatalogoRedes::registrar(const string& rutaRed, const GrafoCSR& grafo) {
+    // Las redes de la carpeta se anotan por nombre; las de otro lado, con su ruta
+    string nombre = fs::path(rutaRed).lexically_relative(carpeta).string();
+    if (nombre.empty() || nombre.compare(0, 2, "..") == 0) nombre = rutaRed;
+
+    // Primero se lee el archivo: si no se puede, el catálogo no cambia
+    uint64_t suma, bytes;
+    if (!sumaArchivo(rutaRed, suma, bytes)) {
+        cerr << "No se pudo leer: " << rutaRed << endl;
+        return false;
+    }
+
+    auto it = find_if(lista.begin(), lista.end(), [&](const RedCatalogada& red) { return red.nombre == nombre; });
+    if (it == lista.end()) {
+        RedCatalogada red;
+        red.numero = numeroDeNombre(nombre);
+        if (red.numero == 0 || buscar(red.numero)) red.numero = siguiente;
+        red.nombre = nombre;
+        it = lista.insert(upper_bound(lista.begin(), lista.end(), red.numero,
+                                      [](int n, const RedCatalogada& r) { return n < r.numero; }),
+                          move(red));
+        siguiente = max(siguiente, it->numero + 1);
+    }
+
+    it->suma = suma;
+    it->bytes = bytes;
+    it->nodos = nodosConEnlaces(grafo);
+    it->enlaces = grafo.destino.size() / 2;
+    return escribir();
+}
+
+bool CatalogoRedes::quitar(int numero) {
+    auto it = find_if(lista.begin(), lista.end(), [&](const RedCatalogada& red) { return red.numero == numero; });
+    if (it == lista.end()) return false;
+    lista.erase(it);
+    return escribir();
+}
+
+// Se escribe al lado y se renombra encima: el reemplazo es atómico
+bool CatalogoRedes::escribir() const {
+    string rutaIndice = (fs::path(carpeta) / NOMBRE_INDICE).string();
+    string temporal = rutaIndice + ".tmp";
+
+    string nombres;
+    vector<EntradaCatalogo> entradas;
+    entradas.reserve(lista.size());
+    for (const RedCatalogada& red : lista) {
+        EntradaCatalogo e{};
+        e.numero = red.numero;
+        e.nodos = red.nodos;
+        e.enlaces = red.enlaces;
+        e.suma = red.suma;
+        e.bytes = red.bytes;
+        e.despNombre = nombres.size();
+        e.largoNombre = red.nombre.size();
+        nombres += red.nombre;
+        entradas.push_back(e);
+    }
+
+    CabeceraCatalogo c{};
+    memcpy(c.magia, MAGIA_CATALOGO, sizeof(c.magia));
+    c.version = VERSION_CATALOGO;
+    c.marcaOrden = MARCA_ORDEN;
+    c.redes = entradas.size();
+    c.siguienteNumero = siguiente;
+    c.bytesNombres = nombres.size();
+
+    {
+        ofstream archivo(temporal, ios::binary | ios::trunc);
+        if (!archivo.is_open()) {
+            cerr << "Error al abrir/crear archivo: " << temporal << endl;
+            return false;
+        }
+        archivo.write((const char*)&c, sizeof(c));
+        archivo.write((const char*)entradas.data(), sizeof(EntradaCatalogo) * entradas.size());
+        archivo.write(nombres.data(), nombres.size());
+        archivo.close();
+        if (!archivo) {
+            cerr << "Error al escribir: " << temporal << endl;
+            return false;
+        }
+    }
+
+    error_code ec;
+    fs::rename(temporal, rutaIndice, ec);
+    if (ec) {
+        cerr << "Error al reemplazar el catálogo: " << rutaIndice << endl;
+        fs::remove(temporal, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,90 @@
+#ifndef CATALOGO_H
+#define CATALOGO_H
+
+#include "grafocsr.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// ===========================
+// Catálogo de redes guardadas
+// ===========================
+// Índice de las redes de una carpeta (Datos/catalogo.idx) para listarlas y
+// abrirlas al arrancar sin recorrer el directorio ni abrir cada archivo.
+// Cada red tiene un número fijo (red_<número>.txt): los números no se
+// reutilizan, así que un hueco en la numeración no esconde las redes que
+// vienen después.
+//
+// Se lee entero al abrir y se reescribe en cada guardado: primero en
+// catalogo.idx.tmp y después se renombra encima del anterior, así que
+// quien lo lea ve la versión anterior o la nueva, nunca una a medias.
+//
+//   CabeceraCatalogo                     32 bytes
+//   EntradaCatalogo[redes]               40 bytes cada una, por número
+//   char nombres[bytesNombres]           nombres de archivo, sin terminador
+//
+// La suma de control es la del contenido del archivo: al abrir una red se
+// compara para notar archivos cambiados o truncados por fuera. Los
+// enrutadores sin enlaces no se guardan en el texto, así que tampoco se
+// cuentan en 'nodos'.
+const char MAGIA_CATALOGO[8] = {'R', 'E', 'D', 'C', 'A', 'T', '\0', '\0'};
+const uint32_t VERSION_CATALOGO = 1;
+
+struct CabeceraCatalogo {
+    char magia[8];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint32_t redes;
+    uint32_t siguienteNumero;
+    uint64_t bytesNombres;
+};
+static_assert(sizeof(CabeceraCatalogo) == 32, "la cabecera del catálogo debe ocupar 32 bytes");
+
+struct EntradaCatalogo {
+    uint32_t numero;
+    uint32_t nodos;
+    uint64_t enlaces;
+    uint64_t suma;            // FNV-1a del contenido del archivo
+    uint64_t bytes;           // tamaño del archivo
+    uint32_t despNombre;      // en la tabla de nombres
+    uint32_t largoNombre;
+};
+static_assert(sizeof(EntradaCatalogo) == 40, "cada entrada del catálogo debe ocupar 40 bytes");
+
+struct RedCatalogada {
+    int numero = 0;
+    std::string nombre;       // relativo a la carpeta del catálogo
+    int nodos = 0;
+    uint64_t enlaces = 0;
+    uint64_t suma = 0;
+    uint64_t bytes = 0;
+};
+
+class CatalogoRedes {
+public:
+    // Lee el índice de la carpeta (la crea si no existe). Si todavía no hay
+    // índice se arma una sola vez con los red_*.txt que haya
+    bool abrir(const std::string& carpeta);
+
+    const std::vector<RedCatalogada>& redes() const { return lista; }
+    const RedCatalogada* buscar(int numero) const;   // nullptr si no está
+    std::string ruta(const RedCatalogada& red) const;
+    std::string rutaNueva() const;                   // red_<siguiente número>.txt
+
+    // Anota (o actualiza) la red recién guardada en 'ruta' y reescribe el índice
+    bool registrar(const std::string& ruta, const GrafoCSR& grafo);
+    bool quitar(int numero);                         // p. ej. si el archivo ya no existe
+    // false si el archivo ya no coincide con lo anotado (tamaño o suma de control)
+    bool verificar(const RedCatalogada& red) const;
+
+private:
+    bool leer(const std::string& rutaIndice);
+    bool escribir() const;
+    void reconstruir();
+
+    std::string carpeta;
+    std::vector<RedCatalogada> lista;   // ordenada por número
+    int siguiente = 1;
+};
+
+#endif // CATALOGO_H
@@ -0,0 +1,14 @@
+TEMPLATE = app
+TARGET = cliente
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+CONFIG += thread
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        main.cpp
+
+HEADERS += \
+    ../protocolo.h
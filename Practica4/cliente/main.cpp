@@ -0,0 +1,214 @@
+#include "protocolo.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Generador de carga para el modo servidor (practica4 --servidor): abre
+// varias conexiones, mantiene 'profundidad' solicitudes en vuelo en cada
+// una y mide consultas por segundo y la latencia de cada respuesta.
+
+using Reloj = chrono::steady_clock;
+
+// Las solicitudes se mandan con send bloqueante y recién después se leen
+// respuestas. Con 4096 en vuelo son 64 KB, muy por debajo de lo que el
+// servidor acepta sin procesar (1 MB): el envío nunca queda esperando a un
+// servidor que a su vez espera que se lean sus respuestas
+const int MAX_PROFUNDIDAD = 4096;
+
+// ============================
+// Conexión bloqueante
+// ============================
+class Conexion {
+public:
+    bool abrir(const string& ruta) {
+        sockaddr_un direccion{};
+        direccion.sun_family = AF_UNIX;
+        if (ruta.size() >= sizeof(direccion.sun_path)) return false;
+        memcpy(direccion.sun_path, ruta.c_str(), ruta.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        return fd >= 0 && connect(fd, (sockaddr*)&direccion, sizeof direccion) == 0;
+    }
+    ~Conexion() { if (fd >= 0) close(fd); }
+
+    bool enviar(const vector<SolicitudRuta>& solicitudes) {
+        const char* datos = (const char*)solicitudes.data();
+        size_t bytes = solicitudes.size() * sizeof(SolicitudRuta);
+        while (bytes > 0) {
+            ssize_t escritos = send(fd, datos, bytes, MSG_NOSIGNAL);
+            if (escritos <= 0) return false;
+            datos += escritos;
+            bytes -= escritos;
+        }
+        return true;
+    }
+
+    // Lee una respuesta completa; la carga queda en 'carga'
+    bool recibir(RespuestaRuta& r, vector<int32_t>& carga) {
+        if (!leer(&r, sizeof r)) return false;
+        carga.resize(r.cantidad);
+        return leer(carga.data(), r.cantidad * sizeof(int32_t));
+    }
+
+private:
+    bool leer(void* destino, size_t bytes) {
+        char* d = (char*)destino;
+        while (bytes > 0) {
+            if (inicio == fin) {
+                ssize_t leidos = recv(fd, bufer, sizeof bufer, 0);
+                if (leidos <= 0) return false;
+                inicio = 0;
+                fin = leidos;
+            }
+            size_t n = min(bytes, fin - inicio);
+            memcpy(d, bufer + inicio, n);
+            inicio += n;
+            d += n;
+            bytes -= n;
+        }
+        return true;
+    }
+
+    int fd = -1;
+    char bufer[1 << 16];
+    size_t inicio = 0, fin = 0;
+};
+
+// ============================
+// Carga
+// ============================
+struct ResultadoHilo {
+    vector<double> latencias;   // microsegundos
+    long long sinRuta = 0, idsInvalidos = 0, errores = 0, enteros = 0;
+    bool ok = true;
+};
+
+void generarCarga(const string& socket, int consultas, int profundidad, uint16_t tipo,
+                  int idMaximo, uint64_t semilla, ResultadoHilo& res) {
+    Conexion c;
+    if (!c.abrir(socket)) { res.ok = false; return; }
+    mt19937_64 gen(semilla);
+    uniform_int_distribution<int> id(1, idMaximo);
+    vector<Reloj::time_point> enviadas(consultas);
+    res.latencias.reserve(consultas);
+
+    vector<SolicitudRuta> tanda;
+    int siguiente = 0, recibidas = 0;
+    auto agregarSolicitudes = [&](int cantidad) {
+        tanda.clear();
+        auto ahora = Reloj::now();
+        for (; cantidad > 0 && siguiente < consultas; --cantidad, ++siguiente) {
+            tanda.push_back(SolicitudRuta{(uint32_t)siguiente, tipo, 0, id(gen), id(gen)});
+            enviadas[siguiente] = ahora;
+        }
+        return tanda.empty() || c.enviar(tanda);
+    };
+
+    if (!agregarSolicitudes(profundidad)) { res.ok = false; return; }
+    RespuestaRuta r;
+    vector<int32_t> carga;
+    while (recibidas < consultas) {
+        if (!c.recibir(r, carga) || r.id != (uint32_t)recibidas) { res.ok = false; return; }
+        res.latencias.push_back(chrono::duration<double, micro>(Reloj::now() - enviadas[r.id]).count());
+        if (r.estado == RESPUESTA_SIN_RUTA) ++res.sinRuta;
+        else if (r.estado == RESPUESTA_ID_INVALIDO) ++res.idsInvalidos;
+        else if (r.estado != RESPUESTA_OK) ++res.errores;
+        res.enteros += r.cantidad;
+        ++recibidas;
+        if (!agregarSolicitudes(1)) { res.ok = false; return; }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    // Uso: cliente [--socket ruta] [--conexiones C] [--consultas Q]
+    //              [--profundidad P] [--tipo costo|ruta|tabla] [--semilla S]
+    string socket = "/tmp/practica4.sock";
+    int conexiones = 4, consultas = 100000, profundidad = 16;
+    string nombreTipo = "ruta";
+    uint64_t semilla = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--socket") socket = argv[i + 1];
+        else if (opcion == "--conexiones") conexiones = atoi(argv[i + 1]);
+        else if (opcion == "--consultas") consultas = atoi(argv[i + 1]);
+        else if (opcion == "--profundidad") profundidad = atoi(argv[i + 1]);
+        else if (opcion == "--tipo") nombreTipo = argv[i + 1];
+        else if (opcion == "--semilla") semilla = strtoull(argv[i + 1], nullptr, 10);
+        else { cerr << "Opción desconocida: " << opcion << "\n"; return 1; }
+    }
+    uint16_t tipo = nombreTipo == "costo" ? SOLICITUD_COSTO
+                  : nombreTipo == "tabla" ? SOLICITUD_TABLA
+                  : nombreTipo == "ruta" ? SOLICITUD_RUTA : 0xFFFF;
+    if (conexiones < 1 || consultas < 1 || profundidad < 1 ||
+        profundidad > MAX_PROFUNDIDAD || tipo == 0xFFFF) {
+        cerr << "Parámetros inválidos (profundidad entre 1 y " << MAX_PROFUNDIDAD << ").\n";
+        return 1;
+    }
+
+    // Los ids de origen y destino se eligen entre 1 y el id más alto; si la
+    // red tiene huecos, los que caen en ellos se cuentan aparte
+    Conexion info;
+    RespuestaRuta r;
+    vector<int32_t> carga;
+    if (!info.abrir(socket) || !info.enviar({SolicitudRuta{0, SOLICITUD_INFO, 0, 0, 0}}) ||
+        !info.recibir(r, carga) || r.estado != RESPUESTA_OK || carga.size() < 2) {
+        cerr << "No se pudo consultar el servidor en " << socket << "\n";
+        return 1;
+    }
+    int nodos = carga[0];
+    int idMaximo = carga.size() >= 3 ? carga[2] : nodos;
+    cout << "Servidor: " << nodos << " enrutadores (id más alto " << idMaximo
+         << "), versión " << carga[1] << "\n";
+    if (nodos < 1 || idMaximo < 1) return 1;
+
+    int porConexion = (consultas + conexiones - 1) / conexiones;
+    vector<ResultadoHilo> resultados(conexiones);
+    vector<thread> hilos;
+    auto t0 = Reloj::now();
+    for (int i = 0; i < conexiones; ++i)
+        hilos.emplace_back(generarCarga, socket, porConexion, profundidad, tipo, idMaximo,
+                           semilla + i, ref(resultados[i]));
+    for (auto& h : hilos) h.join();
+    double segundos = chrono::duration<double>(Reloj::now() - t0).count();
+
+    vector<double> latencias;
+    long long sinRuta = 0, idsInvalidos = 0, errores = 0, enteros = 0;
+    for (auto& res : resultados) {
+        if (!res.ok) {
+            cerr << "Una conexión falló o recibió respuestas fuera de orden.\n";
+            return 1;
+        }
+        latencias.insert(latencias.end(), res.latencias.begin(), res.latencias.end());
+        sinRuta += res.sinRuta;
+        idsInvalidos += res.idsInvalidos;
+        errores += res.errores;
+        enteros += res.enteros;
+    }
+    sort(latencias.begin(), latencias.end());
+    auto percentil = [&](double p) {
+        return latencias[min(latencias.size() - 1, (size_t)(p * latencias.size()))];
+    };
+
+    cout << fixed << setprecision(1);
+    cout << latencias.size() << " consultas (" << nombreTipo << ") en " << conexiones
+         << " conexiones x " << profundidad << " en vuelo: " << segundos << " s, "
+         << (long long)(latencias.size() / segundos) << " consultas/s\n";
+    cout << "Latencia (us): p50 " << percentil(0.50) << "  p90 " << percentil(0.90)
+         << "  p99 " << percentil(0.99) << "  p99.9 " << percentil(0.999)
+         << "  máx " << latencias.back() << "\n";
+    cout << sinRuta << " sin ruta, " << idsInvalidos << " con id inexistente, "
+         << errores << " con error, "
+         << enteros << " enteros recibidos\n";
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "colacalendario.h"
+#include <algorithm>
+using namespace std;
+
+static const size_t CUBETAS_MINIMAS = 2;
+static const size_t PERCENTIL_ANCHO = 90;
+static const long long COSTO_MAXIMO = 4;  // pasos promedio por operación antes de reajustar el ancho
+
+ColaCalendario::ColaCalendario() {
+    vaciar();
+}
+
+void ColaCalendario::vaciar() {
+    cubetas.assign(CUBETAS_MINIMAS, {});
+    ancho = 1;
+    diaActual = 0;
+    costoVentana = 0;
+    opsVentana = 0;
+    reintentos = 0;
+    cantidad = 0;
+    siguienteSecuencia = 0;
+}
+
+// El "día" de un evento es el intervalo de ancho 'ancho' en el que cae; se
+// calcula siempre igual para no acumular error de redondeo
+uint64_t ColaCalendario::dia(double tiempo) const {
+    return tiempo <= 0 ? 0 : (uint64_t)(tiempo / ancho);
+}
+
+size_t ColaCalendario::colocar(const Evento& e) {
+    Cubeta& c = cubetas[dia(e.tiempo) % cubetas.size()];
+    // Los eventos nuevos suelen ser los más tardíos: se busca el lugar desde el final
+    size_t j = c.eventos.size();
+    while (j > c.inicio && antes(e, c.eventos[j - 1])) --j;
+    c.eventos.insert(c.eventos.begin() + j, e);
+    return c.eventos.size() - 1 - j;
+}
+
+// El ancho solo se estima al redimensionar; si la distribución de los
+// tiempos cambió sin que cambie la cantidad de eventos, las operaciones se
+// encarecen y se reajusta. Si reajustar no sirvió (muchos eventos con el
+// mismo tiempo, por ejemplo) la ventana se duplica para no repetirlo en vano
+void ColaCalendario::contarCosto(size_t pasos) {
+    costoVentana += pasos;
+    if (++opsVentana < (max<size_t>(cubetas.size(), 64) << reintentos)) return;
+    bool caro = costoVentana > COSTO_MAXIMO * (long long)opsVentana;
+    costoVentana = 0;
+    opsVentana = 0;
+    if (!caro) {
+        reintentos = 0;
+        return;
+    }
+    reintentos = min(reintentos + 1, 20);
+    redimensionar(cubetas.size());
+}
+
+void ColaCalendario::insertar(Evento e) {
+    e.secuencia = siguienteSecuencia++;
+    size_t pasos = colocar(e);
+    ++cantidad;
+    diaActual = min(diaActual, dia(e.tiempo));
+    if (cantidad > 2 * cubetas.size()) redimensionar(2 * cubetas.size());
+    else contarCosto(pasos);
+}
+
+Evento ColaCalendario::extraerMinimo() {
+    size_t nc = cubetas.size();
+    size_t elegida = nc;
+    size_t k = 0;
+
+    // Recorrido del "año" en curso: el primer evento del día actual es el mínimo
+    for (; k < nc; ++k, ++diaActual) {
+        const Cubeta& c = cubetas[diaActual % nc];
+        if (!c.vacia() && dia(c.primero().tiempo) <= diaActual) {
+            elegida = diaActual % nc;
+            break;
+        }
+    }
+
+    // Sin eventos en este año: búsqueda directa del mínimo
+    if (elegida == nc) {
+        k += nc;
+        for (size_t i = 0; i < nc; ++i)
+            if (!cubetas[i].vacia() && (elegida == nc || antes(cubetas[i].primero(), cubetas[elegida].primero())))
+                elegida = i;
+        diaActual = dia(cubetas[elegida].primero().tiempo);
+    }
+
+    Cubeta& c = cubetas[elegida];
+    Evento e = c.eventos[c.inicio++];
+    if (c.inicio == c.eventos.size()) {
+        c.eventos.clear();
+        c.inicio = 0;
+    } else if (c.inicio >= 64 && 2 * c.inicio >= c.eventos.size()) {
+        c.eventos.erase(c.eventos.begin(), c.eventos.begin() + c.inicio); // compactar
+        c.inicio = 0;
+    }
+    --cantidad;
+    if (nc > CUBETAS_MINIMAS && cantidad < nc / 2) redimensionar(nc / 2);
+    else contarCosto(k);
+    return e;
+}
+
+// Tres veces la separación media entre eventos, medida hasta el percentil
+// 90 para que unos pocos eventos muy lejanos no la inflen. Brown la estima
+// con los primeros eventos, pero eso falla cuando son empates (tiempos
+// redondeados o casi iguales) y da anchos minúsculos
+// (los eventos llegan ordenados)
+double ColaCalendario::estimarAncho(const vector<Evento>& eventos) const {
+    if (eventos.size() < 2) return ancho;
+    size_t rango = (eventos.size() - 1) * PERCENTIL_ANCHO / 100;
+    if (rango == 0) rango = eventos.size() - 1;
+    double nuevo = 3 * (eventos[rango].tiempo - eventos[0].tiempo) / rango;
+    return nuevo > 0 ? nuevo : ancho;
+}
+
+void ColaCalendario::redimensionar(size_t nuevaCantidad) {
+    vector<Evento> eventos;
+    eventos.reserve(cantidad);
+    for (auto& c : cubetas) eventos.insert(eventos.end(), c.eventos.begin() + c.inicio, c.eventos.end());
+    // En orden, cada evento se agrega al final de su cubeta
+    sort(eventos.begin(), eventos.end(), antes);
+
+    ancho = estimarAncho(eventos);
+    cubetas.assign(nuevaCantidad, {});
+    for (const Evento& e : eventos) colocar(e);
+    diaActual = eventos.empty() ? 0 : dia(eventos[0].tiempo);
+    costoVentana = 0;
+    opsVentana = 0;
+}
@@ -0,0 +1,69 @@
+#ifndef COLACALENDARIO_H
+#define COLACALENDARIO_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// ===========================
+// Cola de calendario (Brown, 1988)
+// ===========================
+// Cola de prioridad para simulación de eventos discretos. Los eventos se
+// reparten en 'cubetas' como los días de un calendario: la cubeta de un
+// evento es floor(tiempo / ancho) mod cantidad de cubetas, y la extracción
+// recorre las cubetas en orden revisando solo los eventos del "año" en
+// curso. La cantidad de cubetas se duplica o se reduce a la mitad según la
+// cantidad de eventos, y el ancho se reajusta con la separación media de
+// los próximos eventos (también cuando las operaciones empiezan a costar
+// más de unos pocos pasos), así que insertar y extraer cuestan O(1) en
+// promedio.
+// Los eventos con el mismo tiempo salen en el orden en que se insertaron.
+struct Evento {
+    double tiempo;
+    uint64_t secuencia;  // la asigna la cola; desempata en orden de llegada
+    int tipo;
+    int enrutador;       // quien procesa el evento
+    int origen;          // vecino que lo envió (-1 si no aplica)
+    int dato;
+};
+
+class ColaCalendario {
+public:
+    ColaCalendario();
+
+    void insertar(Evento e);
+    Evento extraerMinimo();  // la cola no debe estar vacía
+    bool vacia() const { return cantidad == 0; }
+    size_t size() const { return cantidad; }
+    void vaciar();
+
+private:
+    // Eventos de menor a mayor; los ya extraídos quedan antes de 'inicio'
+    // hasta que se compacta la cubeta
+    struct Cubeta {
+        std::vector<Evento> eventos;
+        size_t inicio = 0;
+        bool vacia() const { return inicio == eventos.size(); }
+        const Evento& primero() const { return eventos[inicio]; }
+    };
+
+    static bool antes(const Evento& a, const Evento& b) {
+        return a.tiempo != b.tiempo ? a.tiempo < b.tiempo : a.secuencia < b.secuencia;
+    }
+    uint64_t dia(double tiempo) const;
+    size_t colocar(const Evento& e);   // devuelve cuántos eventos quedaron después
+    void contarCosto(size_t pasos);
+    void redimensionar(size_t nuevaCantidad);
+    double estimarAncho(const std::vector<Evento>& eventos) const;
+
+    std::vector<Cubeta> cubetas;
+    double ancho;
+    uint64_t diaActual;    // día que se está recorriendo; no hay eventos de días anteriores
+    size_t cantidad;
+    uint64_t siguienteSecuencia;
+    long long costoVentana;   // pasos acumulados desde el último ajuste
+    size_t opsVentana;
+    int reintentos;           // ajustes seguidos que no abarataron las operaciones
+};
+
+#endif // COLACALENDARIO_H
@@ -1,24 +1,88 @@
 #include "enrutador.h"
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 using namespace std;
 
+// ============================
+// Lista de vecinos
+// ============================
+const Vecino* ListaVecinos::buscar(int indice) const {
+    const Vecino* it = lower_bound(begin(), end(), indice,
+                                   [](const Vecino& v, int i) { return v.indice < i; });
+    return (it != end() && it->indice == indice) ? it : nullptr;
+}
+
+void ListaVecinos::reservar(uint32_t nueva, pmr::memory_resource* arena) {
+    if (nueva <= capacidad) return;
+    Vecino* bloque = (Vecino*)arena->allocate(nueva * sizeof(Vecino), alignof(Vecino));
+    copy(begin(), end(), bloque);
+    if (datos) arena->deallocate(datos, capacidad * sizeof(Vecino), alignof(Vecino));
+    datos = bloque;
+    capacidad = nueva;
+}
+
+void ListaVecinos::asignar(int indice, int costo, pmr::memory_resource* arena) {
+    Vecino* it = lower_bound(datos, datos + cantidad, indice,
+                             [](const Vecino& v, int i) { return v.indice < i; });
+    if (it != datos + cantidad && it->indice == indice) {
+        it->costo = costo;
+        return;
+    }
+    size_t pos = it - datos;
+    if (cantidad == capacidad) reservar(capacidad ? capacidad * 2 : 4, arena);
+    copy_backward(datos + pos, datos + cantidad, datos + cantidad + 1);
+    datos[pos] = {indice, costo};
+    ++cantidad;
+}
+
+bool ListaVecinos::quitar(int indice) {
+    const Vecino* it = buscar(indice);
+    if (!it) return false;
+    size_t pos = it - datos;
+    copy(datos + pos + 1, datos + cantidad, datos + pos);
+    --cantidad;
+    return true;
+}
+
+void ListaVecinos::fusionar(const Vecino* cambios, size_t k, pmr::memory_resource* arena) {
+    if (k == 0) return;
+    uint32_t nueva = cantidad + (uint32_t)k;
+    Vecino* bloque = (Vecino*)arena->allocate(nueva * sizeof(Vecino), alignof(Vecino));
+    uint32_t i = 0, n = 0;
+    for (size_t c = 0; c < k; ++c) {
+        while (i < cantidad && datos[i].indice < cambios[c].indice) bloque[n++] = datos[i++];
+        if (i < cantidad && datos[i].indice == cambios[c].indice) ++i; // el cambio reemplaza al actual
+        if (cambios[c].costo != QUITAR_VECINO) bloque[n++] = cambios[c];
+    }
+    while (i < cantidad) bloque[n++] = datos[i++];
+    if (datos) arena->deallocate(datos, capacidad * sizeof(Vecino), alignof(Vecino));
+    datos = bloque;
+    cantidad = n;
+    capacidad = nueva;
+}
+
+void ListaVecinos::liberar(pmr::memory_resource* arena) {
+    if (datos) arena->deallocate(datos, capacidad * sizeof(Vecino), alignof(Vecino));
+    datos = nullptr;
+    cantidad = capacidad = 0;
+}
+
 // ============================
 // Constructor
 // ============================
-Router::Router(int id) : id(id) {}
+Router::Router(int id, pmr::memory_resource* arena) : id(id), arena(arena) {}
 
 // ============================
 // Métodos básicos
 // ============================
-void Router::nuevoVecino(Router* vecino, int costo) {
-    if (!vecino || vecino == this) return; // evita punteros nulos o bucles
-    vecinos[vecino] = costo;
+void Router::nuevoVecino(int indice, int costo) {
+    if (indice < 0) return; // el bucle consigo mismo lo descarta la Red, que conoce el índice propio
+    vecinos.asignar(indice, costo, arena);
 }
 
-void Router::eliminarVecino(Router* vecino) {
-    if (!vecino) return;
-    vecinos.erase(vecino);
+void Router::eliminarVecino(int indice) {
+    vecinos.quitar(indice);
 }
 
 // ============================
@@ -28,14 +92,14 @@ string Router::getNombre() const {
     return "R" + to_string(id);
 }
 
-map<string, int> Router::getTabla() const {
+map<string, int> Router::getTabla(const vector<Router>& red) const {
     map<string, int> tabla;
     for (auto& [v, c] : vecinos)
-        if (v) tabla[v->getNombre()] = c;
+        tabla[red[v].getNombre()] = c;
     return tabla;
 }
 
-void Router::mostrarConexiones() const {
+void Router::mostrarConexiones(const vector<Router>& red) const {
     cout << getNombre() << " -> ";
     if (vecinos.empty()) {
         cout << "sin conexiones";
@@ -43,7 +107,7 @@ void Router::mostrarConexiones() const {
         bool first = true;
         for (auto& [v, c] : vecinos) {
             if (!first) cout << ", ";
-            cout << v->getNombre() << "(" << c << ")";
+            cout << red[v].getNombre() << "(" << c << ")";
             first = false;
         }
     }
@@ -59,12 +123,12 @@ void Router::agregarConexion(const string& nombreVecino, int costo) {
     cout << " [aviso] agregarConexion(" << nombreVecino << ") debe hacerse desde Red.\n";
 }
 
-void Router::eliminarConexion(const string& nombreVecino) {
-    for (auto it = vecinos.begin(); it != vecinos.end(); ) {
-        if (it->first && it->first->getNombre() == nombreVecino)
-            it = vecinos.erase(it);
-        else
-            ++it;
+void Router::eliminarConexion(const string& nombreVecino, const vector<Router>& red) {
+    for (auto& [v, c] : vecinos) {
+        if (red[v].getNombre() == nombreVecino) {
+            vecinos.quitar(v);
+            return;
+        }
     }
 }
 
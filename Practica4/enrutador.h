@@ -3,25 +3,65 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <cstdint>
+#include <memory_resource>
 using namespace std;
 
+// Enlace hacia un vecino: posición del vecino en la red y costo
+struct Vecino {
+    int indice;
+    int costo;
+};
+
+// Costo que indica, en ListaVecinos::fusionar, que el vecino se quita
+const int QUITAR_VECINO = -1;
+
+// Lista de vecinos ordenada por índice, en un bloque contiguo pedido a la
+// arena de la red. No libera nada al destruirse: la memoria se devuelve
+// a la arena explícitamente (liberar) o toda junta al reemplazar la red.
+class ListaVecinos {
+public:
+    const Vecino* begin() const { return datos; }
+    const Vecino* end() const { return datos + cantidad; }
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+    const Vecino& operator[](size_t i) const { return datos[i]; }
+
+    const Vecino* buscar(int indice) const;       // nullptr si no es vecino
+    void asignar(int indice, int costo, pmr::memory_resource* arena); // inserta o cambia el costo
+    bool quitar(int indice);
+    // Aplica en una sola pasada 'cantidad' cambios ordenados por índice y sin
+    // repetidos (costo QUITAR_VECINO = quitar ese vecino)
+    void fusionar(const Vecino* cambios, size_t cantidad, pmr::memory_resource* arena);
+    void reservar(uint32_t capacidad, pmr::memory_resource* arena);
+    void liberar(pmr::memory_resource* arena);
+
+private:
+    Vecino* datos = nullptr;
+    uint32_t cantidad = 0;
+    uint32_t capacidad = 0;
+};
+
 class Router {
 public:
-    int id;
-    map<Router*, int> vecinos;
+    int id;                          // 0 = ranura libre
+    uint32_t generacion = 0;         // sube cada vez que la ranura se libera
+    ListaVecinos vecinos;            // (ranura, costo) ordenados por ranura
+    pmr::memory_resource* arena;     // de donde sale la memoria de 'vecinos'
 
-    Router(int id);
-    void nuevoVecino(Router* vecino, int costo);
-    void eliminarVecino(Router* vecino);
+    Router(int id, pmr::memory_resource* arena);
+    void nuevoVecino(int indice, int costo);
+    void eliminarVecino(int indice);
 
     // Métodos nuevos:
     string getNombre() const;                       // Devuelve "R" + id
-    map<string, int> getTabla() const;              // Convierte vecinos a <string,int>
-    void mostrarConexiones() const;
+    map<string, int> getTabla(const vector<Router>& red) const;   // Convierte vecinos a <string,int>
+    void mostrarConexiones(const vector<Router>& red) const;
 
     // Métodos adicionales necesarios:
     void agregarConexion(const string& nombreVecino, int costo);
-    void eliminarConexion(const string& nombreVecino);
+    void eliminarConexion(const string& nombreVecino, const vector<Router>& red);
     void mostrarTablaEnrutamiento(const map<string, pair<int, string>>& tabla) const;
 };
 
@@ -0,0 +1,75 @@
+#include "estadoenlace.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+using namespace std;
+
+InformeLS SimuladorEstadoEnlace::simular(const GrafoCSR& grafo, const vector<int>& origenes) {
+    InformeLS informe;
+    auto t0 = chrono::steady_clock::now();
+
+    g = &grafo;
+    int n = grafo.cantidadNodos();
+    k = (int)origenes.size();
+    instalado.assign((size_t)n * k, 0);
+    primeraLlegada.assign((size_t)n * k, numeric_limits<double>::max());
+    spfPendiente.assign(n, 0);
+    ultimoSPF.assign(n, numeric_limits<double>::lowest());
+    informe.convergencia.assign(n, -1);
+    informe.lsas = k;
+    cola.vaciar();
+
+    for (int l = 0; l < k; ++l)
+        if (origenes[l] >= 0 && origenes[l] < n) instalar(origenes[l], l, 0, -1, informe);
+
+    while (!cola.vacia()) {
+        Evento e = cola.extraerMinimo();
+        ++informe.eventos;
+        if (e.tipo == LLEGADA_LSA) {
+            size_t celda = (size_t)e.enrutador * k + e.dato;
+            if (instalado[celda] || e.tiempo > primeraLlegada[celda]) ++informe.duplicados;
+            else instalar(e.enrutador, e.dato, e.tiempo, e.origen, informe);
+        } else {
+            // El SPF usa la LSDB tal como está al empezar; lo que llegue
+            // después programa otro
+            spfPendiente[e.enrutador] = 0;
+            ultimoSPF[e.enrutador] = e.tiempo;
+            ++informe.ejecucionesSPF;
+            informe.convergencia[e.enrutador] = e.tiempo + config.duracionSPF;
+        }
+    }
+
+    for (double c : informe.convergencia) informe.total = max(informe.total, c);
+    informe.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    g = nullptr;
+    return informe;
+}
+
+// Primera copia de un LSA: se instala, se programa el SPF si no hay uno
+// pendiente y se reenvía por todos los enlaces menos por el que llegó
+void SimuladorEstadoEnlace::instalar(int enrutador, int lsa, double tiempo, int desde, InformeLS& informe) {
+    instalado[(size_t)enrutador * k + lsa] = 1;
+    primeraLlegada[(size_t)enrutador * k + lsa] = tiempo;
+
+    if (!spfPendiente[enrutador]) {
+        spfPendiente[enrutador] = 1;
+        double inicio = max(tiempo + config.spfRetardo, ultimoSPF[enrutador] + config.spfEspera);
+        cola.insertar({inicio, 0, INICIO_SPF, enrutador, -1, 0});
+    }
+
+    // Una copia que llegaría después de otra ya en camino (o ya instalada) es
+    // un duplicado seguro: se cuenta sin pasar por la cola
+    for (int e = g->inicio[enrutador]; e < g->inicio[enrutador + 1]; ++e) {
+        int v = g->destino[e];
+        if (v == desde) continue;
+        ++informe.mensajes;
+        double llegada = tiempo + config.procesamiento + g->costo[e] * config.retardoPorCosto;
+        double& primera = primeraLlegada[(size_t)v * k + lsa];
+        if (llegada >= primera) {
+            ++informe.duplicados;
+            continue;
+        }
+        primera = llegada;
+        cola.insertar({llegada, 0, LLEGADA_LSA, v, enrutador, lsa});
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef ESTADOENLACE_H
+#define ESTADOENLACE_H
+
+#include "grafocsr.h"
+#include "colacalendario.h"
+#include <vector>
+#include <cstdint>
+
+// ===========================
+// Simulación de estado de enlace (OSPF) por eventos discretos
+// ===========================
+// Antes de cada cambio todos los enrutadores tienen la misma base de datos
+// de estado de enlace (LSDB). Los enrutadores que notan el cambio (los
+// extremos del enlace, o los vecinos del enrutador eliminado) originan un
+// LSA nuevo en el instante 0, y cada LSA se inunda: quien lo recibe por
+// primera vez lo instala y lo reenvía a todos sus vecinos menos al que se
+// lo mandó; las copias repetidas se descartan. Cada salto tarda el tiempo
+// de procesamiento más el costo del enlace por el retardo por unidad.
+//
+// Cada instalación en la LSDB programa un cálculo SPF con el
+// estrangulamiento de OSPF: espera inicial tras el primer cambio y un
+// intervalo mínimo entre dos cálculos seguidos; los LSA que llegan
+// mientras hay uno pendiente se incluyen en ese. Un enrutador converge
+// cuando termina su último SPF. La duración del SPF es un parámetro: las
+// tablas que resultan son las de Dijkstra sobre la red nueva.
+//
+// Los eventos se ordenan en una cola de calendario, así que cada uno
+// cuesta O(1) en promedio y una inundación de millones de eventos sobre
+// decenas de miles de enrutadores tarda segundos.
+
+// Tiempos en milisegundos simulados
+struct ConfiguracionLS {
+    double retardoPorCosto = 1;   // propagación por unidad de costo del enlace
+    double procesamiento = 0.5;   // recibir, instalar y reenviar un LSA
+    double spfRetardo = 50;       // espera entre el primer cambio y el SPF
+    double spfEspera = 200;       // separación mínima entre dos SPF del mismo enrutador
+    double duracionSPF = 1;
+};
+
+struct InformeLS {
+    std::vector<double> convergencia; // por enrutador; -1 si no recibió ningún LSA
+    double total = 0;                 // el último enrutador en converger
+    int lsas = 0;                     // LSA originados por el cambio
+    long long eventos = 0;            // eventos procesados por la cola
+    long long mensajes = 0;           // LSA enviados por los enlaces
+    long long duplicados = 0;         // copias recibidas de un LSA ya instalado
+    long long ejecucionesSPF = 0;
+    double ms = 0;                    // tiempo real de la simulación
+};
+
+class SimuladorEstadoEnlace {
+public:
+    explicit SimuladorEstadoEnlace(const ConfiguracionLS& configuracion) : config(configuracion) {}
+
+    // 'grafo' es la red ya modificada; 'origenes', los índices de los
+    // enrutadores que originan un LSA
+    InformeLS simular(const GrafoCSR& grafo, const std::vector<int>& origenes);
+
+    const ConfiguracionLS& configuracion() const { return config; }
+
+private:
+    enum TipoEvento { LLEGADA_LSA, INICIO_SPF };
+
+    void instalar(int enrutador, int lsa, double tiempo, int desde, InformeLS& informe);
+
+    ConfiguracionLS config;
+    const GrafoCSR* g = nullptr;
+    int k = 0;                           // LSA en vuelo
+    ColaCalendario cola;
+    std::vector<uint8_t> instalado;      // n x k: el enrutador ya tiene el LSA
+    std::vector<double> primeraLlegada;  // n x k: copia más temprana enviada hasta ahora
+    std::vector<uint8_t> spfPendiente;
+    std::vector<double> ultimoSPF;       // inicio del último SPF de cada enrutador
+};
+
+#endif // ESTADOENLACE_H
@@ -0,0 +1,197 @@
+#include "exportacion.h"
+#include "formatobinario.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+using namespace std;
+
+static const size_t BUFER_ARCHIVO = 4 << 20;     // búfer del archivo de salida
+static const size_t MEMORIA_BLOQUE = 64 << 20;   // tope aproximado de un bloque de filas
+
+static uint64_t alinear8(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+
+void siguientesSaltos(const int* prev, int origen, int n, int* salto, vector<int>& pila) {
+    const int DESCONOCIDO = -2;
+    fill(salto, salto + n, DESCONOCIDO);
+    for (int d = 0; d < n; ++d) {
+        // Se sube hasta un nodo ya resuelto o hasta un hijo directo del origen
+        pila.clear();
+        int x = d;
+        while (salto[x] == DESCONOCIDO) {
+            int p = prev[x];
+            if (p == origen) { salto[x] = x; break; }
+            if (p < 0) { salto[x] = -1; break; } // el origen o un inalcanzable
+            pila.push_back(x);
+            x = p;
+        }
+        for (int y : pila) salto[y] = salto[x];
+    }
+}
+
+// ============================
+// Formato de una fila
+// ============================
+namespace {
+
+// Escribe sobre un búfer ya dimensionado; el llamador reserva el máximo
+struct Escritor {
+    char* p;
+
+    void caracter(char c) { *p++ = c; }
+    void numero(int x) { p = to_chars(p, p + 11, x).ptr; }
+    void nombre(const GrafoCSR& g, int i) { *p++ = 'R'; numero(g.ids[i]); }
+};
+
+// Cota de bytes por celda: 'R' o ',' más hasta 11 caracteres por número
+const size_t MAX_NUMERO = 12;
+
+size_t formatearDistancias(const GrafoCSR& g, int o, const int* dist, int n, string& texto) {
+    texto.resize(MAX_NUMERO * (n + 2));
+    Escritor e{&texto[0]};
+    e.nombre(g, o);
+    for (int d = 0; d < n; ++d) {
+        e.caracter(',');
+        if (dist[d] != INFINITO) e.numero(dist[d]);
+    }
+    e.caracter('\n');
+    return e.p - texto.data();
+}
+
+size_t formatearTabla(const GrafoCSR& g, int o, const int* dist, const int* salto, int n, string& texto) {
+    texto.resize(4 * MAX_NUMERO * (size_t)n);
+    Escritor e{&texto[0]};
+    for (int d = 0; d < n; ++d) {
+        if (d == o || dist[d] == INFINITO) continue;
+        e.nombre(g, o);
+        e.caracter(',');
+        e.nombre(g, d);
+        e.caracter(',');
+        e.numero(dist[d]);
+        e.caracter(',');
+        e.nombre(g, salto[d]);
+        e.caracter('\n');
+    }
+    return e.p - texto.data();
+}
+
+template <typename T>
+size_t empaquetarFila(const int* dist, const int* salto, int n, bool conSaltos, string& bytes) {
+    size_t tamDist = 4ull * n, tamSalto = conSaltos ? sizeof(T) * n : 0;
+    bytes.assign(alinear8(tamDist + tamSalto), '\0');
+    memcpy(&bytes[0], dist, tamDist);
+    if (conSaltos) {
+        T* destino = (T*)(&bytes[0] + tamDist);
+        for (int d = 0; d < n; ++d) destino[d] = (T)salto[d]; // -1 queda en el máximo del tipo sin signo
+    }
+    return bytes.size();
+}
+
+} // namespace
+
+// ============================
+// Exportación
+// ============================
+bool exportarRutas(const GrafoCSR& g, const MatrizTodosLosPares* cache, PoolHilos& pool,
+                   const string& ruta, FormatoExportacion formato, ContenidoExportacion contenido) {
+    int n = g.cantidadNodos();
+    bool conSaltos = contenido == ContenidoExportacion::Tablas;
+    bool binario = formato == FormatoExportacion::Binario;
+    if (cache && conSaltos && !cache->conPredecesores()) cache = nullptr;
+
+    vector<char> bufer(BUFER_ARCHIVO);
+    ofstream archivo;
+    archivo.rdbuf()->pubsetbuf(bufer.data(), bufer.size());
+    archivo.open(ruta, binario ? ios::binary | ios::trunc : ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir/crear archivo: " << ruta << endl;
+        return false;
+    }
+
+    // Cabecera
+    uint32_t anchoSalto = !conSaltos ? 0 : MatrizTodosLosPares::angosta(n) ? 2 : 4;
+    if (binario) {
+        CabeceraMatriz c{};
+        memcpy(c.magia, MAGIA_MATRIZ, sizeof(c.magia));
+        c.version = VERSION_MATRIZ;
+        c.marcaOrden = MARCA_ORDEN;
+        c.nodos = n;
+        c.contenido = conSaltos ? 1 : 0;
+        c.anchoSalto = anchoSalto;
+        c.despIds = sizeof(CabeceraMatriz);
+        c.despFilas = alinear8(c.despIds + 4ull * n);
+        c.bytesFila = alinear8(4ull * n + (uint64_t)anchoSalto * n);
+        archivo.write((const char*)&c, sizeof(c));
+        archivo.write((const char*)g.ids.datos, 4ull * n);
+        static const char ceros[8] = {};
+        archivo.write(ceros, c.despFilas - (c.despIds + 4ull * n));
+    } else if (conSaltos) {
+        archivo << "origen,destino,costo,siguiente_salto\n";
+    } else {
+        string encabezado;
+        encabezado.resize(MAX_NUMERO * (n + 1));
+        Escritor e{&encabezado[0]};
+        for (int d = 0; d < n; ++d) {
+            e.caracter(',');
+            e.nombre(g, d);
+        }
+        e.caracter('\n');
+        archivo.write(encabezado.data(), e.p - encabezado.data());
+    }
+
+    // Filas por bloque: suficientes para ocupar el pool, sin pasar del tope de memoria
+    size_t bytesPorFila = (size_t)n * (8 + (conSaltos ? 4 * MAX_NUMERO : MAX_NUMERO));
+    int porBloque = (int)max<size_t>(1, min<size_t>(MEMORIA_BLOQUE / max<size_t>(1, bytesPorFila), 256));
+    porBloque = min(porBloque, max(1, n));
+
+    struct Espacio {
+        vector<int> dist, prev, salto, pila;
+        EspacioDijkstra dijkstra;
+    };
+    vector<Espacio> espacios(pool.cantidadHilos());
+    vector<string> textos(porBloque);
+    vector<size_t> largos(porBloque);
+
+    for (int primero = 0; primero < n; primero += porBloque) {
+        int cuantos = min(porBloque, n - primero);
+        pool.paraCada(cuantos, [&](int k, int hilo) {
+            int o = primero + k;
+            Espacio& e = espacios[hilo];
+            e.dist.resize(n);
+            if (conSaltos) {
+                e.prev.resize(n);
+                e.salto.resize(n);
+            }
+
+            const int* dist;
+            if (cache) {
+                dist = cache->filaDist(o);
+                if (conSaltos) cache->copiarFilaPrev(o, e.prev.data());
+            } else {
+                dijkstra(g, o, e.dist.data(), conSaltos ? e.prev.data() : nullptr, e.dijkstra);
+                dist = e.dist.data();
+            }
+            if (conSaltos) siguientesSaltos(e.prev.data(), o, n, e.salto.data(), e.pila);
+
+            if (!binario)
+                largos[k] = conSaltos ? formatearTabla(g, o, dist, e.salto.data(), n, textos[k])
+                                      : formatearDistancias(g, o, dist, n, textos[k]);
+            else if (anchoSalto == 2)
+                largos[k] = empaquetarFila<uint16_t>(dist, e.salto.data(), n, conSaltos, textos[k]);
+            else
+                largos[k] = empaquetarFila<int32_t>(dist, e.salto.data(), n, conSaltos, textos[k]);
+        });
+
+        for (int k = 0; k < cuantos; ++k) archivo.write(textos[k].data(), largos[k]);
+        if (!archivo) break;
+    }
+
+    archivo.close();
+    if (!archivo) {
+        cerr << "Error al escribir: " << ruta << endl;
+        return false;
+    }
+    return true;
+}
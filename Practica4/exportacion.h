@@ -0,0 +1,65 @@
+#ifndef EXPORTACION_H
+#define EXPORTACION_H
+
+#include "grafocsr.h"
+#include "todospares.h"
+#include "poolhilos.h"
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// ===========================
+// Exportación de la matriz de costos y las tablas de enrutamiento
+// ===========================
+// Las filas se escriben en orden de origen a medida que se obtienen: de la
+// caché de rutas si está al día o, si no, con un Dijkstra por origen en
+// bloques de filas calculadas en paralelo. Así la memoria queda acotada
+// por el bloque y no por la matriz n x n. Los números se convierten con
+// to_chars directamente en el búfer de cada fila y el archivo se escribe
+// con un búfer grande, sin el formato de iostream.
+//
+// CSV de distancias:   ,R1,R2,...        (celda vacía = sin ruta)
+//                      R1,0,7,,12
+// CSV de tablas:       origen,destino,costo,siguiente_salto
+//                      R1,R5,12,R3       (solo pares con ruta, sin la diagonal)
+//
+// Binario (orden de bytes de la máquina, detectado con MARCA_ORDEN):
+//
+//   CabeceraMatriz                       56 bytes
+//   int32 ids[nodos]                     en despIds
+//   filas[nodos]                         en despFilas, de bytesFila cada una
+//
+// Cada fila tiene int32 dist[nodos] (INFINITO = sin ruta) y, con tablas,
+// el índice del siguiente salto de cada destino en anchoSalto bytes
+// (uint16 con menos de 65535 nodos, 65535 = ninguno; si no, int32, -1).
+// Las filas empiezan en múltiplos de 8.
+enum class FormatoExportacion { CSV, Binario };
+enum class ContenidoExportacion { Distancias, Tablas };
+
+const char MAGIA_MATRIZ[8] = {'R', 'E', 'D', 'R', 'U', 'T', 'A', 'S'};
+const uint32_t VERSION_MATRIZ = 1;
+
+struct CabeceraMatriz {
+    char magia[8];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint32_t nodos;
+    uint32_t contenido;     // 0 = distancias, 1 = distancias y siguiente salto
+    uint32_t anchoSalto;    // 0, 2 o 4
+    uint32_t reservado;
+    uint64_t despIds;
+    uint64_t despFilas;
+    uint64_t bytesFila;
+};
+static_assert(sizeof(CabeceraMatriz) == 56, "la cabecera de la matriz debe ocupar 56 bytes");
+
+// 'cache' puede ser nullptr (o no tener predecesores, si solo se piden
+// distancias). Devuelve false si no se pudo escribir el archivo.
+bool exportarRutas(const GrafoCSR& grafo, const MatrizTodosLosPares* cache, PoolHilos& pool,
+                   const std::string& ruta, FormatoExportacion formato, ContenidoExportacion contenido);
+
+// Siguiente salto desde 'origen' hacia cada destino a partir de la fila de
+// predecesores (-1 para el origen y los inalcanzables). O(n) en total
+void siguientesSaltos(const int* prev, int origen, int n, int* salto, std::vector<int>& pila);
+
+#endif // EXPORTACION_H
@@ -0,0 +1,101 @@
+#include "floydwarshall.h"
+#include <algorithm>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// ============================
+// Núcleo SIMD: fila[j] = min(fila[j], aik + bk[j])
+// ============================
+static inline void minSuma(int* fila, const int* bk, int aik, int len) {
+    int j = 0;
+#if defined(__AVX2__)
+    __m256i a = _mm256_set1_epi32(aik);
+    for (; j + 8 <= len; j += 8) {
+        __m256i b = _mm256_loadu_si256((const __m256i*)(bk + j));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(fila + j));
+        _mm256_storeu_si256((__m256i*)(fila + j), _mm256_min_epi32(c, _mm256_add_epi32(a, b)));
+    }
+#elif defined(__SSE4_1__)
+    __m128i a = _mm_set1_epi32(aik);
+    for (; j + 4 <= len; j += 4) {
+        __m128i b = _mm_loadu_si128((const __m128i*)(bk + j));
+        __m128i c = _mm_loadu_si128((const __m128i*)(fila + j));
+        _mm_storeu_si128((__m128i*)(fila + j), _mm_min_epi32(c, _mm_add_epi32(a, b)));
+    }
+#endif
+    for (; j < len; ++j)
+        fila[j] = min(fila[j], aik + bk[j]);
+}
+
+// c = min(c, a (x) b) para un bloque; a, b y c pueden ser el mismo bloque
+static void actualizarBloque(int* c, const int* a, const int* b, int ancho) {
+    const int B = TAM_BLOQUE_FW;
+    for (int k = 0; k < B; ++k) {
+        const int* bk = b + (size_t)k * ancho;
+        for (int i = 0; i < B; ++i) {
+            int aik = a[(size_t)i * ancho + k];
+            if (aik >= INF_FW) continue; // sin camino i -> k: la fila no cambia
+            minSuma(c + (size_t)i * ancho, bk, aik, B);
+        }
+    }
+}
+
+// ============================
+// Algoritmo por fases
+// ============================
+void floydWarshallBloques(const GrafoCSR& g, PoolHilos& pool, vector<int>& dist) {
+    int n = g.cantidadNodos();
+    const int B = TAM_BLOQUE_FW;
+    int nb = (n + B - 1) / B;
+    int ancho = nb * B; // la matriz interna se rellena hasta múltiplo del bloque
+
+    vector<int> d((size_t)ancho * ancho, INF_FW);
+    for (int i = 0; i < n; ++i) {
+        int* fila = d.data() + (size_t)i * ancho;
+        fila[i] = 0;
+        for (int e = g.inicio[i]; e < g.inicio[i + 1]; ++e)
+            fila[g.destino[e]] = min(fila[g.destino[e]], g.costo[e]);
+    }
+
+    auto bloque = [&](int bi, int bj) { return d.data() + (size_t)bi * B * ancho + (size_t)bj * B; };
+
+    for (int kb = 0; kb < nb; ++kb) {
+        int* diag = bloque(kb, kb);
+
+        // Fase 1: bloque diagonal
+        actualizarBloque(diag, diag, diag, ancho);
+
+        // Fase 2: fila y columna del bloque kb
+        pool.paraCada(2 * nb, [&](int t, int) {
+            int otro = t / 2;
+            if (otro == kb) return;
+            if (t % 2 == 0) {
+                int* c = bloque(kb, otro);
+                actualizarBloque(c, diag, c, ancho);
+            } else {
+                int* c = bloque(otro, kb);
+                actualizarBloque(c, c, diag, ancho);
+            }
+        });
+
+        // Fase 3: resto de bloques, una fila de bloques por tarea
+        pool.paraCada(nb, [&](int bi, int) {
+            if (bi == kb) return;
+            const int* a = bloque(bi, kb);
+            for (int bj = 0; bj < nb; ++bj) {
+                if (bj == kb) continue;
+                actualizarBloque(bloque(bi, bj), a, bloque(kb, bj), ancho);
+            }
+        });
+    }
+
+    dist.resize((size_t)n * n);
+    for (int i = 0; i < n; ++i) {
+        const int* fila = d.data() + (size_t)i * ancho;
+        int* salida = dist.data() + (size_t)i * n;
+        for (int j = 0; j < n; ++j)
+            salida[j] = fila[j] >= INF_FW ? INFINITO : fila[j];
+    }
+}
@@ -0,0 +1,28 @@
+#ifndef FLOYDWARSHALL_H
+#define FLOYDWARSHALL_H
+
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <vector>
+
+// ===========================
+// Floyd–Warshall por bloques
+// ===========================
+// Variante (min, +) por mosaicos de TAM_BLOQUE_FW x TAM_BLOQUE_FW sobre una
+// matriz contigua fila mayor. Los bucles internos usan SIMD (AVX2 o SSE4.1
+// si el compilador los habilita) y los bloques de cada fase se reparten en
+// el pool de hilos. Pensado para topologías densas como las de
+// Red::generarRedAleatoria.
+const int TAM_BLOQUE_FW = 64;
+
+// Infinito interno: la suma de dos infinitos no desborda un int. Un camino
+// que cueste esto o más se confundiría con "sin ruta", así que el algoritmo
+// solo sirve si costoMaximo * (n - 1) queda por debajo (ver
+// convieneFloydWarshall)
+const int INF_FW = INT_MAX / 2;
+
+// Deja en dist (n*n, fila mayor) los costos mínimos; INFINITO si no hay ruta.
+// Los resultados son idénticos a los de un Dijkstra por origen.
+void floydWarshallBloques(const GrafoCSR& grafo, PoolHilos& pool, std::vector<int>& dist);
+
+#endif // FLOYDWARSHALL_H
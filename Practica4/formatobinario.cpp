@@ -0,0 +1,233 @@
+#include "formatobinario.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define MAPEO_POSIX 1
+#endif
+using namespace std;
+
+static_assert(sizeof(int) == sizeof(int32_t), "el formato binario asume int de 32 bits");
+
+static uint64_t alinear8(uint64_t x) { return (x + 7) & ~uint64_t(7); }
+
+bool esArchivoBinario(const string& ruta) {
+    ifstream archivo(ruta, ios::binary);
+    char magia[8] = {};
+    return archivo.read(magia, sizeof(magia)) && memcmp(magia, MAGIA_BINARIA, sizeof(magia)) == 0;
+}
+
+// ============================
+// Escritura
+// ============================
+// Se escribe en <ruta>.tmp y se renombra encima: la red puede estar mapeada
+// desde el mismo archivo (truncarlo rompería el mapeo) y, si la escritura
+// falla, el archivo anterior queda intacto
+bool guardarBinario(const GrafoCSR& g, const string& ruta) {
+    string temporal = ruta + ".tmp";
+    ofstream archivo(temporal, ios::binary | ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir/crear archivo: " << temporal << endl;
+        return false;
+    }
+
+    CabeceraBinaria c{};
+    memcpy(c.magia, MAGIA_BINARIA, sizeof(c.magia));
+    c.version = VERSION_BINARIA;
+    c.marcaOrden = MARCA_ORDEN;
+    c.nodos = g.cantidadNodos();
+    c.entradas = g.destino.size();
+    c.costoMinimo = g.costoMinimo;
+    c.costoMaximo = g.costoMaximo;
+    c.despIds = sizeof(CabeceraBinaria);
+    c.despInicio = alinear8(c.despIds + 4ull * c.nodos);
+    c.despDestino = alinear8(c.despInicio + 4ull * (c.nodos + 1));
+    c.despCosto = alinear8(c.despDestino + 4ull * c.entradas);
+
+    uint64_t escrito = 0;
+    auto escribir = [&](uint64_t desp, const void* datos, uint64_t bytes) {
+        static const char ceros[8] = {};
+        archivo.write(ceros, desp - escrito); // relleno de alineación
+        archivo.write((const char*)datos, bytes);
+        escrito = desp + bytes;
+    };
+
+    escribir(0, &c, sizeof(c));
+    escribir(c.despIds, g.ids.datos, 4ull * c.nodos);
+    escribir(c.despInicio, g.inicio.datos, 4ull * (c.nodos + 1));
+    escribir(c.despDestino, g.destino.datos, 4ull * c.entradas);
+    escribir(c.despCosto, g.costo.datos, 4ull * c.entradas);
+
+    archivo.close();
+    if (!archivo) {
+        cerr << "Error al escribir: " << temporal << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+    if (rename(temporal.c_str(), ruta.c_str()) != 0) {
+        cerr << "Error al reemplazar: " << ruta << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ============================
+// Lectura por mapeo
+// ============================
+namespace {
+
+// Mantiene viva la región mapeada (o, sin mmap, una copia leída del archivo)
+struct RegionArchivo {
+    const char* base = nullptr;
+    size_t bytes = 0;
+    vector<char> copia;
+
+    ~RegionArchivo() {
+#ifdef MAPEO_POSIX
+        if (base && copia.empty()) munmap((void*)base, bytes);
+#endif
+    }
+};
+
+shared_ptr<RegionArchivo> abrirRegion(const string& ruta) {
+    auto region = make_shared<RegionArchivo>();
+#ifdef MAPEO_POSIX
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) { close(fd); return nullptr; }
+    void* p = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return nullptr;
+    region->base = (const char*)p;
+    region->bytes = info.st_size;
+#else
+    ifstream archivo(ruta, ios::binary | ios::ate);
+    if (!archivo.is_open()) return nullptr;
+    region->copia.resize((size_t)archivo.tellg());
+    archivo.seekg(0);
+    archivo.read(region->copia.data(), region->copia.size());
+    region->base = region->copia.data();
+    region->bytes = region->copia.size();
+#endif
+    return region;
+}
+
+} // namespace
+
+bool mapearBinario(const string& ruta, GrafoCSR& g) {
+    shared_ptr<RegionArchivo> region = abrirRegion(ruta);
+    if (!region) {
+        cerr << "No se pudo abrir el archivo: " << ruta << endl;
+        return false;
+    }
+
+    CabeceraBinaria c;
+    if (region->bytes < sizeof(c)) {
+        cerr << "Archivo binario truncado: " << ruta << endl;
+        return false;
+    }
+    memcpy(&c, region->base, sizeof(c));
+
+    if (memcmp(c.magia, MAGIA_BINARIA, sizeof(c.magia)) != 0) {
+        cerr << "El archivo no tiene formato binario de red: " << ruta << endl;
+        return false;
+    }
+    if (c.marcaOrden != MARCA_ORDEN) {
+        cerr << "El archivo binario fue escrito con otro orden de bytes: " << ruta << endl;
+        return false;
+    }
+    if (c.version != VERSION_BINARIA) {
+        cerr << "Versión de formato binario no soportada (" << c.version << "): " << ruta << endl;
+        return false;
+    }
+
+    auto cabe = [&](uint64_t desp, uint64_t elementos) {
+        return desp % 4 == 0 && desp <= region->bytes && elementos <= (region->bytes - desp) / 4;
+    };
+    if (!cabe(c.despIds, c.nodos) || !cabe(c.despInicio, c.nodos + 1ull) ||
+        !cabe(c.despDestino, c.entradas) || !cabe(c.despCosto, c.entradas)) {
+        cerr << "Archivo binario truncado: " << ruta << endl;
+        return false;
+    }
+
+    auto arreglo = [&](uint64_t desp, uint64_t elementos) {
+        return Tramo<int>{(const int*)(region->base + desp), (size_t)elementos};
+    };
+    GrafoCSR nuevo;
+    nuevo.ids = arreglo(c.despIds, c.nodos);
+    nuevo.inicio = arreglo(c.despInicio, c.nodos + 1ull);
+    nuevo.destino = arreglo(c.despDestino, c.entradas);
+    nuevo.costo = arreglo(c.despCosto, c.entradas);
+
+    // Validar los desplazamientos: el resto de la aplicación confía en ellos
+    if (nuevo.inicio[0] != 0 || (uint64_t)nuevo.inicio[c.nodos] != c.entradas) {
+        cerr << "Desplazamientos CSR inválidos en: " << ruta << endl;
+        return false;
+    }
+    for (uint32_t i = 0; i < c.nodos; ++i) {
+        if (nuevo.inicio[i] > nuevo.inicio[i + 1]) {
+            cerr << "Desplazamientos CSR inválidos en: " << ruta << endl;
+            return false;
+        }
+    }
+    // Cada fila, con vecinos en rango y estrictamente crecientes (las FIB y
+    // la carga a listas buscan en ellas)
+    for (uint32_t i = 0; i < c.nodos; ++i) {
+        for (int e = nuevo.inicio[i]; e < nuevo.inicio[i + 1]; ++e) {
+            int v = nuevo.destino[e];
+            if (v < 0 || (uint32_t)v >= c.nodos || (uint32_t)v == i) {
+                cerr << "Vecino fuera de rango o enlace a sí mismo en: " << ruta << endl;
+                return false;
+            }
+            if (e > nuevo.inicio[i] && v <= nuevo.destino[e - 1]) {
+                cerr << "Vecinos desordenados o repetidos en: " << ruta << endl;
+                return false;
+            }
+        }
+    }
+    // Los enlaces son bidireccionales (FIB, jerarquía y reparación de la
+    // caché lo suponen): cada (i, v, c) necesita su (v, i, c). Las filas ya
+    // están ordenadas, así que se busca por búsqueda binaria
+    for (uint32_t i = 0; i < c.nodos; ++i) {
+        for (int e = nuevo.inicio[i]; e < nuevo.inicio[i + 1]; ++e) {
+            int v = nuevo.destino[e];
+            const int* finFila = nuevo.destino.begin() + nuevo.inicio[v + 1];
+            const int* it = lower_bound(nuevo.destino.begin() + nuevo.inicio[v], finFila, (int)i);
+            if (it == finFila || *it != (int)i || nuevo.costo[it - nuevo.destino.begin()] != nuevo.costo[e]) {
+                cerr << "Enlace sin su sentido inverso (o con otro costo) en: " << ruta << endl;
+                return false;
+            }
+        }
+    }
+
+    // Los extremos de costo eligen el núcleo de Dijkstra y el tamaño de sus
+    // cubetas: se recalculan en lugar de creerle a la cabecera
+    if (c.entradas > 0) {
+        auto [minimo, maximo] = minmax_element(nuevo.costo.begin(), nuevo.costo.end());
+        nuevo.costoMinimo = *minimo;
+        nuevo.costoMaximo = *maximo;
+    }
+    if (nuevo.costoMinimo != c.costoMinimo || nuevo.costoMaximo != c.costoMaximo)
+        cerr << "Extremos de costo de la cabecera corregidos en: " << ruta << endl;
+
+    // Los ids se buscan por búsqueda binaria: deben ser positivos y crecientes
+    for (uint32_t i = 0; i < c.nodos; ++i) {
+        if (nuevo.ids[i] <= 0 || (i > 0 && nuevo.ids[i] <= nuevo.ids[i - 1])) {
+            cerr << "Ids de enrutadores inválidos en: " << ruta << endl;
+            return false;
+        }
+    }
+
+    nuevo.almacen = region;
+    g = move(nuevo);
+    return true;
+}
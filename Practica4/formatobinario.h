@@ -0,0 +1,56 @@
+#ifndef FORMATOBINARIO_H
+#define FORMATOBINARIO_H
+
+#include "grafocsr.h"
+#include <string>
+#include <cstdint>
+
+// ===========================
+// Formato binario de topologías
+// ===========================
+// Guarda la instantánea CSR tal cual está en memoria para poder mapear el
+// archivo y usarlo sin copiar ni parsear. Disposición (orden de bytes de la
+// máquina, detectado con marcaOrden):
+//
+//   CabeceraBinaria                      80 bytes
+//   int32 ids[nodos]                     en despIds, crecientes
+//   int32 inicio[nodos + 1]              en despInicio
+//   int32 destino[entradas]              en despDestino
+//   int32 costo[entradas]                en despCosto
+//
+// Cada arreglo empieza en un desplazamiento múltiplo de 8. 'entradas' cuenta
+// los enlaces en ambos sentidos (2 por enlace de la red); al mapear se
+// rechazan los archivos con un sentido sin el otro, con costos distintos en
+// cada sentido o con enlaces de un enrutador a sí mismo.
+const char MAGIA_BINARIA[8] = {'R', 'E', 'D', 'C', 'S', 'R', '\0', '\0'};
+const uint32_t VERSION_BINARIA = 1;
+const uint32_t MARCA_ORDEN = 0x01020304;
+
+struct CabeceraBinaria {
+    char magia[8];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint32_t nodos;
+    int32_t costoMinimo;
+    int32_t costoMaximo;
+    uint32_t reservado;
+    uint64_t entradas;
+    uint64_t despIds;
+    uint64_t despInicio;
+    uint64_t despDestino;
+    uint64_t despCosto;
+    uint64_t reservado2;
+};
+static_assert(sizeof(CabeceraBinaria) == 80, "la cabecera binaria debe ocupar 80 bytes");
+
+// true si el archivo empieza con la firma del formato binario
+bool esArchivoBinario(const std::string& ruta);
+
+// Escribe la instantánea en formato binario
+bool guardarBinario(const GrafoCSR& grafo, const std::string& ruta);
+
+// Mapea el archivo en memoria y arma la instantánea sobre él (sin copias).
+// El mapeo se libera cuando desaparece la última copia de la instantánea.
+bool mapearBinario(const std::string& ruta, GrafoCSR& grafo);
+
+#endif // FORMATOBINARIO_H
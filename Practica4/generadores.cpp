@@ -0,0 +1,263 @@
+#include "generadores.h"
+#include <vector>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+// Filas de G(n, p) por tarea; cada bloque usa su propio flujo aleatorio
+static const int FILAS_POR_BLOQUE = 1024;
+
+// ============================
+// Aleatorio
+// ============================
+uint64_t mezclar64(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+static inline uint64_t rotar(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+Aleatorio::Aleatorio(uint64_t semilla, uint64_t flujo) {
+    uint64_t x = semilla ^ mezclar64(flujo);
+    for (auto& v : s) v = x = mezclar64(x);
+}
+
+uint64_t Aleatorio::siguiente() {
+    uint64_t resultado = rotar(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotar(s[3], 45);
+    return resultado;
+}
+
+double Aleatorio::uniforme() {
+    return (siguiente() >> 11) * 0x1.0p-53;
+}
+
+int Aleatorio::entre(int minimo, int maximo) {
+    uint64_t rango = (uint64_t)((long long)maximo - minimo) + 1;
+    return (int)(minimo + (long long)(siguiente() % rango));
+}
+
+// ============================
+// Costos
+// ============================
+int costoEnlace(const ModeloCosto& modelo, uint64_t semilla, int u, int v) {
+    if (modelo.tipo == DistribucionCosto::Constante) return modelo.minimo;
+
+    uint64_t a = (uint64_t)(uint32_t)min(u, v), b = (uint64_t)(uint32_t)max(u, v);
+    double x = (mezclar64(semilla ^ mezclar64((a << 32) | b)) >> 11) * 0x1.0p-53;
+    double ancho = (double)modelo.maximo - modelo.minimo;
+
+    double c;
+    if (modelo.tipo == DistribucionCosto::Uniforme)
+        c = modelo.minimo + floor(x * (ancho + 1));
+    else
+        c = modelo.minimo + floor(-log1p(-x) * max(1.0, ancho / 4));
+    return (int)min(c, (double)modelo.maximo);
+}
+
+// ============================
+// Armado de la instantánea
+// ============================
+
+// Cada enlace (u, v) sin repetir se guarda en ambos sentidos; las listas
+// quedan ordenadas por vecino
+static GrafoCSR armarCSR(int n, const vector<pair<int,int>>& enlaces, const ParametrosTopologia& p) {
+    ArreglosCSR a;
+    a.ids.resize(n);
+    for (int i = 0; i < n; ++i) a.ids[i] = i + 1;
+
+    a.inicio.assign(n + 1, 0);
+    for (auto [u, v] : enlaces) {
+        ++a.inicio[u + 1];
+        ++a.inicio[v + 1];
+    }
+    for (int i = 0; i < n; ++i) a.inicio[i + 1] += a.inicio[i];
+
+    vector<pair<int,int>> entradas(a.inicio[n]); // (vecino, costo)
+    vector<int> pos(a.inicio.begin(), a.inicio.end() - 1);
+    for (auto [u, v] : enlaces) {
+        int c = costoEnlace(p.costo, p.semilla, u, v);
+        entradas[pos[u]++] = {v, c};
+        entradas[pos[v]++] = {u, c};
+    }
+
+    a.destino.resize(entradas.size());
+    a.costo.resize(entradas.size());
+    for (int i = 0; i < n; ++i) {
+        auto ini = entradas.begin() + a.inicio[i], fin = entradas.begin() + a.inicio[i + 1];
+        if (!is_sorted(ini, fin)) sort(ini, fin);
+        for (int e = a.inicio[i]; e < a.inicio[i + 1]; ++e) {
+            a.destino[e] = entradas[e].first;
+            a.costo[e] = entradas[e].second;
+        }
+    }
+    return empaquetarCSR(move(a));
+}
+
+// ============================
+// Modelos
+// ============================
+static void enlacesCompleta(int n, vector<pair<int,int>>& enlaces) {
+    enlaces.reserve((size_t)n * (n - 1) / 2);
+    for (int u = 0; u < n; ++u)
+        for (int v = u + 1; v < n; ++v)
+            enlaces.push_back({u, v});
+}
+
+// G(n, p) saltando directamente al siguiente par presente (Batagelj y
+// Brandes): el salto es geométrico, así que el costo es O(n + m)
+static void enlacesErdosRenyi(int n, double gradoMedio, uint64_t semilla, PoolHilos& pool,
+                              vector<pair<int,int>>& enlaces) {
+    double prob = min(1.0, gradoMedio / (n - 1));
+    if (prob <= 0) return;
+    double logq = log1p(-prob);
+
+    int bloques = (n + FILAS_POR_BLOQUE - 1) / FILAS_POR_BLOQUE;
+    vector<vector<pair<int,int>>> porBloque(bloques);
+    pool.paraCada(bloques, [&](int b, int) {
+        Aleatorio rng(semilla, (uint64_t)b + 1);
+        auto& salida = porBloque[b];
+        int hasta = min(n, (b + 1) * FILAS_POR_BLOQUE);
+        // Con el grado esperado real: gradoMedio puede superar n - 1
+        salida.reserve((size_t)(prob * (n - 1) / 2 * (hasta - b * FILAS_POR_BLOQUE) * 1.1));
+        for (int u = b * FILAS_POR_BLOQUE; u < hasta; ++u) {
+            double v = u;
+            while (true) {
+                v += prob >= 1 ? 1 : 1 + floor(log1p(-rng.uniforme()) / logq);
+                if (v >= n) break;
+                salida.push_back({u, (int)v});
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (auto& b : porBloque) total += b.size();
+    enlaces.reserve(total);
+    for (auto& b : porBloque) {
+        enlaces.insert(enlaces.end(), b.begin(), b.end());
+        vector<pair<int,int>>().swap(b);
+    }
+}
+
+// Enlace preferencial: cada extremo de enlace se anota en 'extremos', así
+// que elegir una posición al azar equivale a elegir un enrutador con
+// probabilidad proporcional a su grado
+static void enlacesBarabasiAlbert(int n, int m, uint64_t semilla, vector<pair<int,int>>& enlaces) {
+    Aleatorio rng(semilla);
+    int semillaRed = min(n, m + 1); // núcleo inicial completo
+    enlaces.reserve((size_t)n * m);
+    vector<int> extremos;
+    extremos.reserve((size_t)2 * n * m);
+
+    for (int u = 0; u < semillaRed; ++u)
+        for (int v = u + 1; v < semillaRed; ++v) {
+            enlaces.push_back({u, v});
+            extremos.push_back(u);
+            extremos.push_back(v);
+        }
+
+    vector<int> elegidos;
+    for (int t = semillaRed; t < n; ++t) {
+        elegidos.clear();
+        while ((int)elegidos.size() < m) {
+            int v = extremos[rng.entre(0, (int)extremos.size() - 1)];
+            if (find(elegidos.begin(), elegidos.end(), v) == elegidos.end()) elegidos.push_back(v);
+        }
+        for (int v : elegidos) {
+            enlaces.push_back({v, t});
+            extremos.push_back(v);
+            extremos.push_back(t);
+        }
+    }
+}
+
+static void enlacesMalla(int n, int columnas, vector<pair<int,int>>& enlaces) {
+    enlaces.reserve((size_t)2 * n);
+    for (int i = 0; i < n; ++i) {
+        if ((i % columnas) + 1 < columnas && i + 1 < n) enlaces.push_back({i, i + 1});
+        if (i + columnas < n) enlaces.push_back({i, i + columnas});
+    }
+}
+
+// Índices: primero los (k/2)² de núcleo; luego cada pod ocupa k posiciones,
+// k/2 de agregación seguidos de k/2 de borde
+static void enlacesFatTree(int k, vector<pair<int,int>>& enlaces) {
+    int mitad = k / 2;
+    int nucleo = mitad * mitad;
+    enlaces.reserve((size_t)k * k * k / 2);
+    for (int pod = 0; pod < k; ++pod) {
+        int base = nucleo + pod * k;
+        for (int a = 0; a < mitad; ++a) {
+            int agregacion = base + a;
+            for (int c = 0; c < mitad; ++c) enlaces.push_back({a * mitad + c, agregacion});
+            for (int e = 0; e < mitad; ++e) enlaces.push_back({agregacion, base + mitad + e});
+        }
+    }
+}
+
+bool generarTopologia(const ParametrosTopologia& p, PoolHilos& pool, GrafoCSR& grafo) {
+    if (p.costo.minimo < 0 || p.costo.maximo < p.costo.minimo) {
+        cerr << "Rango de costos inválido.\n";
+        return false;
+    }
+
+    long long n = p.modelo == ModeloTopologia::FatTree ? nodosFatTree(p.k) : p.nodos;
+    long long enlacesEsperados = 0;
+    switch (p.modelo) {
+    case ModeloTopologia::Completa:       enlacesEsperados = n * (n - 1) / 2; break;
+    case ModeloTopologia::ErdosRenyi:     enlacesEsperados = (long long)(n * p.gradoMedio / 2); break;
+    case ModeloTopologia::BarabasiAlbert: enlacesEsperados = n * (long long)p.enlacesPorNodo; break;
+    case ModeloTopologia::Malla:          enlacesEsperados = 2 * n; break;
+    case ModeloTopologia::FatTree:        enlacesEsperados = (long long)p.k * p.k * p.k / 2; break;
+    }
+    if (p.modelo == ModeloTopologia::FatTree && (p.k < 2 || p.k % 2 != 0)) {
+        cerr << "El fat-tree necesita un k par mayor o igual a 2.\n";
+        return false;
+    }
+    if (n <= 0 || n > INT_MAX || 2 * enlacesEsperados >= INT_MAX) {
+        cerr << "Tamaño de red fuera de rango.\n";
+        return false;
+    }
+    if (p.modelo == ModeloTopologia::ErdosRenyi && p.gradoMedio < 0) {
+        cerr << "El grado medio no puede ser negativo.\n";
+        return false;
+    }
+    if (p.modelo == ModeloTopologia::BarabasiAlbert && p.enlacesPorNodo < 1) {
+        cerr << "Se necesita al menos un enlace por enrutador nuevo.\n";
+        return false;
+    }
+
+    vector<pair<int,int>> enlaces;
+    switch (p.modelo) {
+    case ModeloTopologia::Completa:
+        enlacesCompleta((int)n, enlaces);
+        break;
+    case ModeloTopologia::ErdosRenyi:
+        if (n > 1) enlacesErdosRenyi((int)n, p.gradoMedio, p.semilla, pool, enlaces);
+        break;
+    case ModeloTopologia::BarabasiAlbert:
+        enlacesBarabasiAlbert((int)n, p.enlacesPorNodo, p.semilla, enlaces);
+        break;
+    case ModeloTopologia::Malla: {
+        int columnas = p.columnas > 0 ? p.columnas : max(1, (int)lround(sqrt((double)n)));
+        enlacesMalla((int)n, columnas, enlaces);
+        break;
+    }
+    case ModeloTopologia::FatTree:
+        enlacesFatTree(p.k, enlaces);
+        break;
+    }
+
+    grafo = armarCSR((int)n, enlaces, p);
+    return true;
+}
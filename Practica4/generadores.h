@@ -0,0 +1,73 @@
+#ifndef GENERADORES_H
+#define GENERADORES_H
+
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <cstdint>
+
+// ===========================
+// Números aleatorios reproducibles
+// ===========================
+// xoshiro256** sembrado con SplitMix64. Cada (semilla, flujo) da una
+// secuencia independiente, así que cada hilo o cada bloque de trabajo puede
+// usar su propio flujo y el resultado no depende del reparto entre hilos.
+class Aleatorio {
+public:
+    Aleatorio(uint64_t semilla, uint64_t flujo = 0);
+
+    uint64_t siguiente();
+    double uniforme();              // [0, 1)
+    int entre(int minimo, int maximo); // [minimo, maximo]
+
+private:
+    uint64_t s[4];
+};
+
+uint64_t mezclar64(uint64_t x);     // paso de SplitMix64
+
+// ===========================
+// Generadores de topologías
+// ===========================
+enum class ModeloTopologia {
+    Completa,        // todos los pares, O(n²)
+    ErdosRenyi,      // G(n, p) con p = gradoMedio / (n - 1)
+    BarabasiAlbert,  // enlace preferencial, 'enlacesPorNodo' enlaces por enrutador nuevo
+    Malla,           // cuadrícula de 'columnas' columnas, vecinos arriba/abajo/izquierda/derecha
+    FatTree          // fat-tree de k puertos: (k/2)² núcleo + k pods de k/2 agregación y k/2 borde
+};
+
+enum class DistribucionCosto {
+    Uniforme,        // entero uniforme en [minimo, maximo]
+    Exponencial,     // minimo + exponencial de media (maximo - minimo) / 4, recortada a maximo
+    Constante        // siempre minimo
+};
+
+struct ModeloCosto {
+    DistribucionCosto tipo = DistribucionCosto::Uniforme;
+    int minimo = 1;
+    int maximo = 20;
+};
+
+struct ParametrosTopologia {
+    ModeloTopologia modelo = ModeloTopologia::ErdosRenyi;
+    int nodos = 0;              // todos menos FatTree
+    double gradoMedio = 4;      // ErdosRenyi
+    int enlacesPorNodo = 2;     // BarabasiAlbert
+    int columnas = 0;           // Malla (0 = raíz cuadrada de nodos)
+    int k = 4;                  // FatTree (par)
+    ModeloCosto costo;
+    uint64_t semilla = 1;
+};
+
+// El costo de cada enlace depende solo de la semilla y de sus extremos, no
+// del orden en que se generan los enlaces
+int costoEnlace(const ModeloCosto& modelo, uint64_t semilla, int u, int v);
+
+// Enrutadores de un fat-tree de k puertos
+inline long long nodosFatTree(int k) { return 5LL * k * k / 4; }
+
+// Arma la instantánea en O(n + m) (salvo Completa). Los ids quedan 1..N.
+// Informa por cerr y devuelve false si los parámetros no son válidos.
+bool generarTopologia(const ParametrosTopologia& parametros, PoolHilos& pool, GrafoCSR& grafo);
+
+#endif // GENERADORES_H
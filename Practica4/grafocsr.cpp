@@ -0,0 +1,212 @@
+#include "grafocsr.h"
+#include "matrizcostos.h"
+#include "instrumentacion.h"
+#include <algorithm>
+using namespace std;
+
+// ============================
+// Construcción de la instantánea
+// ============================
+GrafoCSR empaquetarCSR(ArreglosCSR arreglos) {
+    auto datos = make_shared<ArreglosCSR>(move(arreglos));
+
+    GrafoCSR g;
+    g.inicio = {datos->inicio.data(), datos->inicio.size()};
+    g.destino = {datos->destino.data(), datos->destino.size()};
+    g.costo = {datos->costo.data(), datos->costo.size()};
+    g.ids = {datos->ids.data(), datos->ids.size()};
+
+    if (!datos->costo.empty()) {
+        auto [minimo, maximo] = minmax_element(datos->costo.begin(), datos->costo.end());
+        g.costoMinimo = *minimo;
+        g.costoMaximo = *maximo;
+    }
+    g.almacen = datos;
+    return g;
+}
+
+GrafoCSR construirGrafoCSR(const vector<Router>& enrutadores, const MatrizCostos* matriz) {
+    ArreglosCSR a;
+    int ranuras = enrutadores.size();
+
+    // Vecinos de una ranura desde la disposición que esté en uso
+    auto paraCadaVecino = [&](int r, auto&& f) {
+        if (matriz) matriz->paraCadaVecino(r, f);
+        else for (auto& [v, c] : enrutadores[r].vecinos) f(v, c);
+    };
+    auto grado = [&](int r) {
+        return matriz ? matriz->grado(r) : (int)enrutadores[r].vecinos.size();
+    };
+
+    // Ranuras ocupadas en orden de id. Mientras no se reutilice una ranura
+    // libre ese orden ya es el de las ranuras y no hace falta ordenar
+    vector<int> orden;
+    orden.reserve(ranuras);
+    bool enOrden = true;
+    for (int r = 0; r < ranuras; ++r) {
+        if (enrutadores[r].id == 0) continue;
+        if (!orden.empty() && enrutadores[orden.back()].id > enrutadores[r].id) enOrden = false;
+        orden.push_back(r);
+    }
+    if (!enOrden)
+        sort(orden.begin(), orden.end(), [&](int x, int y) { return enrutadores[x].id < enrutadores[y].id; });
+
+    int n = orden.size();
+    vector<int> indice(ranuras, -1);
+    a.ids.resize(n);
+    a.inicio.assign(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        indice[orden[i]] = i;
+        a.ids[i] = enrutadores[orden[i]].id;
+        a.inicio[i + 1] = a.inicio[i] + grado(orden[i]);
+    }
+
+    // Los vecinos salen ordenados por ranura; con las ranuras en orden de id
+    // siguen ordenados al traducirlos a índices, si no se reordenan
+    a.destino.resize(a.inicio[n]);
+    a.costo.resize(a.inicio[n]);
+    vector<Vecino> lista;
+    for (int i = 0; i < n; ++i) {
+        int pos = a.inicio[i];
+        if (enOrden) {
+            paraCadaVecino(orden[i], [&](int v, int c) {
+                a.destino[pos] = indice[v];
+                a.costo[pos] = c;
+                ++pos;
+            });
+            continue;
+        }
+        lista.clear();
+        paraCadaVecino(orden[i], [&](int v, int c) { lista.push_back({indice[v], c}); });
+        sort(lista.begin(), lista.end(), [](const Vecino& x, const Vecino& y) { return x.indice < y.indice; });
+        for (auto& [v, c] : lista) {
+            a.destino[pos] = v;
+            a.costo[pos] = c;
+            ++pos;
+        }
+    }
+    return empaquetarCSR(move(a));
+}
+
+int indiceDeId(const GrafoCSR& g, int id) {
+    auto it = lower_bound(g.ids.begin(), g.ids.end(), id);
+    return it != g.ids.end() && *it == id ? (int)(it - g.ids.begin()) : -1;
+}
+
+// ============================
+// Dijkstra sobre índices
+// ============================
+void dijkstra(const GrafoCSR& g, int origen, vector<int>& dist, vector<int>& prev) {
+    int n = g.cantidadNodos();
+    dist.resize(n);
+    prev.resize(n);
+    EspacioDijkstra espacio;
+    dijkstra(g, origen, dist.data(), prev.data(), espacio);
+}
+
+void dijkstra(const GrafoCSR& g, int origen, int* dist, int* prev, EspacioDijkstra& espacio) {
+    if (g.costoMinimo >= 0 && g.costoMaximo <= UMBRAL_COSTO_CUBETAS)
+        dijkstraCubetas(g, origen, dist, prev, espacio);
+    else
+        dijkstraMonticulo(g, origen, dist, prev, espacio);
+}
+
+void dijkstraMonticulo(const GrafoCSR& g, int origen, int* dist, int* prev, EspacioDijkstra& espacio) {
+    int n = g.cantidadNodos();
+    fill(dist, dist + n, INFINITO);
+    if (prev) fill(prev, prev + n, -1);
+    if (origen < 0 || origen >= n) return;
+
+    // Montículo de mínimos sobre el vector del espacio de trabajo (no reserva en cada llamada)
+    auto& pq = espacio.monticulo;
+    greater<pair<int,int>> cmp;
+    ConteoRecorrido conteo;
+    CONTAR(EJECUCIONES_DIJKSTRA, 1);
+    pq.clear();
+    dist[origen] = 0;
+    pq.push_back({0, origen});
+    ++conteo.inserciones;
+
+    while (!pq.empty()) {
+        pop_heap(pq.begin(), pq.end(), cmp);
+        auto [d, u] = pq.back(); pq.pop_back();
+        ++conteo.extracciones;
+        if (d > dist[u]) {
+            ++conteo.viejas;
+            continue;
+        }
+
+        conteo.relajaciones += g.inicio[u + 1] - g.inicio[u];
+        for (int e = g.inicio[u]; e < g.inicio[u + 1]; ++e) {
+            int v = g.destino[e];
+            int nd = d + g.costo[e];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                if (prev) prev[v] = u;
+                pq.push_back({nd, v});
+                push_heap(pq.begin(), pq.end(), cmp);
+                ++conteo.inserciones;
+            }
+        }
+    }
+}
+
+// Cola de cubetas de Dial: con costos en [0, C] todas las distancias
+// pendientes caben en C + 1 cubetas circulares indexadas por distancia.
+void dijkstraCubetas(const GrafoCSR& g, int origen, int* dist, int* prev, EspacioDijkstra& espacio) {
+    int n = g.cantidadNodos();
+    fill(dist, dist + n, INFINITO);
+    if (prev) fill(prev, prev + n, -1);
+    if (origen < 0 || origen >= n) return;
+
+    int anillo = g.costoMaximo + 1;
+    auto& cubetas = espacio.cubetas;
+    if ((int)cubetas.size() < anillo) cubetas.resize(anillo);
+    for (int i = 0; i < anillo; ++i) cubetas[i].clear();
+
+    ConteoRecorrido conteo;
+    CONTAR(EJECUCIONES_DIJKSTRA, 1);
+    dist[origen] = 0;
+    cubetas[0].push_back(origen);
+    long long pendientes = 1;
+    conteo.inserciones = 1;
+
+    for (int d = 0; pendientes > 0; ++d) {
+        auto& actual = cubetas[d % anillo];
+        // los enlaces de costo 0 agregan a la misma cubeta: se consume como pila
+        while (!actual.empty()) {
+            int u = actual.back(); actual.pop_back();
+            --pendientes;
+            ++conteo.extracciones;
+            if (dist[u] != d) { // entrada vieja
+                ++conteo.viejas;
+                continue;
+            }
+
+            conteo.relajaciones += g.inicio[u + 1] - g.inicio[u];
+            for (int e = g.inicio[u]; e < g.inicio[u + 1]; ++e) {
+                int v = g.destino[e];
+                int nd = d + g.costo[e];
+                if (nd < dist[v]) {
+                    dist[v] = nd;
+                    if (prev) prev[v] = u;
+                    cubetas[nd % anillo].push_back(v);
+                    ++pendientes;
+                    ++conteo.inserciones;
+                }
+            }
+        }
+    }
+}
+
+vector<int> reconstruirCamino(const int* prev, int origen, int destino) {
+    vector<int> camino;
+    if (destino != origen && prev[destino] == -1) return camino;
+
+    for (int cur = destino; cur != -1; cur = prev[cur]) {
+        camino.push_back(cur);
+        if (cur == origen) break;
+    }
+    reverse(camino.begin(), camino.end());
+    return camino;
+}
@@ -0,0 +1,97 @@
+#ifndef GRAFOCSR_H
+#define GRAFOCSR_H
+
+#include "enrutador.h"
+#include <vector>
+#include <memory>
+#include <climits>
+#include <cstddef>
+
+// Valor usado en los vectores de distancias para "sin ruta"
+const int INFINITO = INT_MAX;
+
+// Vista de solo lectura sobre un arreglo contiguo (un vector propio o un
+// archivo mapeado en memoria)
+template <typename T>
+struct Tramo {
+    const T* datos = nullptr;
+    size_t cantidad = 0;
+
+    const T& operator[](size_t i) const { return datos[i]; }
+    size_t size() const { return cantidad; }
+    bool empty() const { return cantidad == 0; }
+    const T* begin() const { return datos; }
+    const T* end() const { return datos + cantidad; }
+};
+
+// ===========================
+// Instantánea CSR de la red
+// ===========================
+// Representación compacta (compressed sparse row) de la adyacencia:
+// los vecinos del nodo i están en destino[inicio[i] .. inicio[i+1]-1]
+// con su costo en la misma posición de costo[]. Los nodos se numeran
+// 0..n-1 en orden creciente de id (los ids no tienen por qué ser
+// consecutivos: se conservan al eliminar enrutadores y al cargar archivos).
+//
+// Es inmutable: los arreglos viven en 'almacen' (vectores o un archivo
+// mapeado), compartido entre copias, así que copiar la instantánea es barato.
+struct GrafoCSR {
+    Tramo<int> inicio;         // n + 1 desplazamientos
+    Tramo<int> destino;        // índice del vecino
+    Tramo<int> costo;          // costo del enlace
+    Tramo<int> ids;            // id del enrutador (R<id>) de cada índice
+    int costoMinimo = 0;       // extremos de costo, para elegir el núcleo de Dijkstra
+    int costoMaximo = 0;
+    std::shared_ptr<const void> almacen;
+
+    int cantidadNodos() const { return (int)ids.size(); }
+    std::string nombre(int indice) const { return "R" + std::to_string(ids[indice]); }
+};
+
+// Arreglos propios con los que se arma una instantánea
+struct ArreglosCSR {
+    std::vector<int> inicio;
+    std::vector<int> destino;
+    std::vector<int> costo;
+    std::vector<int> ids;
+};
+
+// Toma posesión de los arreglos y calcula los extremos de costo
+GrafoCSR empaquetarCSR(ArreglosCSR arreglos);
+
+class MatrizCostos;
+
+// Construye la instantánea a partir de la tabla de ranuras de la Red, con
+// los vecinos de Router::vecinos o, si se pasa, de la matriz de costos
+// (ambas por ranura); las ranuras libres se saltean
+GrafoCSR construirGrafoCSR(const std::vector<Router>& enrutadores, const MatrizCostos* matriz = nullptr);
+
+// Índice del id en la instantánea, por búsqueda binaria (-1 si no existe)
+int indiceDeId(const GrafoCSR& grafo, int id);
+
+// Con costos enteros en [0, UMBRAL_COSTO_CUBETAS] se usa la cola de cubetas
+// (Dial); con costos mayores o negativos, el montículo binario.
+const int UMBRAL_COSTO_CUBETAS = 256;
+
+// Memoria de trabajo de Dijkstra, reutilizable entre llamadas (una por hilo)
+struct EspacioDijkstra {
+    std::vector<std::pair<int,int>> monticulo; // (distancia, nodo)
+    std::vector<std::vector<int>> cubetas;     // cola circular de Dial
+};
+
+// Dijkstra desde un origen sobre índices densos.
+// dist[i] queda en INFINITO si no hay ruta, prev[i] en -1 si no tiene predecesor.
+void dijkstra(const GrafoCSR& grafo, int origen, std::vector<int>& dist, std::vector<int>& prev);
+
+// Variante sin reservas: escribe en dist[0..n) y prev[0..n) (prev puede ser nullptr).
+// Elige el núcleo según los costos de la instantánea.
+void dijkstra(const GrafoCSR& grafo, int origen, int* dist, int* prev, EspacioDijkstra& espacio);
+
+// Núcleos concretos (los usa dijkstra(); expuestos para el benchmark)
+void dijkstraMonticulo(const GrafoCSR& grafo, int origen, int* dist, int* prev, EspacioDijkstra& espacio);
+void dijkstraCubetas(const GrafoCSR& grafo, int origen, int* dist, int* prev, EspacioDijkstra& espacio);
+
+// Reconstruye el camino origen -> ... -> destino usando prev (vacío si no hay ruta)
+std::vector<int> reconstruirCamino(const int* prev, int origen, int destino);
+
+#endif // GRAFOCSR_H
@@ -0,0 +1,232 @@
+#include "instrumentacion.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <vector>
+using namespace std;
+
+// ============================
+// Registro de los bloques de cada hilo
+// ============================
+namespace {
+
+// Bloques de los hilos vivos y suma de los que ya terminaron. Solo se toca
+// al registrar un hilo, al terminar uno y al armar el informe.
+struct Registro {
+    mutex m;
+    vector<BloqueInstrumentacion*> vivos;
+    ResumenInstrumentacion terminados;
+    ResumenInstrumentacion base;   // resumen al último reinicio
+};
+
+Registro& registro() {
+    static Registro* r = new Registro(); // nunca se destruye: los hilos pueden terminar después de main
+    return *r;
+}
+
+void acumular(const BloqueInstrumentacion& b, ResumenInstrumentacion& r) {
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c) r.contadores[c] += b.contadores[c].load(memory_order_relaxed);
+    for (int f = 0; f < CANTIDAD_FASES; ++f) {
+        for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+            r.contadoresFase[f][c] += b.contadoresFase[f][c].load(memory_order_relaxed);
+        r.llamadas[f] += b.llamadas[f].load(memory_order_relaxed);
+        r.nanosegundos[f] += b.nanosegundos[f].load(memory_order_relaxed);
+    }
+}
+
+// Bloque del hilo con alta y baja en el registro. El bloque en sí es
+// trivial (se inicializa en cero sin constructor) para que operator new
+// pueda contar incluso mientras se registra el hilo.
+thread_local BloqueInstrumentacion bloque;
+thread_local bool registrado = false;
+
+struct BajaAlTerminar {
+    ~BajaAlTerminar() {
+        Registro& r = registro();
+        lock_guard<mutex> candado(r.m);
+        acumular(bloque, r.terminados);
+        ++r.terminados.hilos;
+        for (size_t i = 0; i < r.vivos.size(); ++i)
+            if (r.vivos[i] == &bloque) {
+                r.vivos[i] = r.vivos.back();
+                r.vivos.pop_back();
+                break;
+            }
+    }
+};
+
+// Totales de los contadores de todo el proceso (sin descontar el reinicio:
+// las fases solo usan diferencias)
+void totalesContadores(uint64_t totales[CANTIDAD_CONTADORES]) {
+    Registro& r = registro();
+    lock_guard<mutex> candado(r.m);
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c) totales[c] = r.terminados.contadores[c];
+    for (const BloqueInstrumentacion* b : r.vivos)
+        for (int c = 0; c < CANTIDAD_CONTADORES; ++c) totales[c] += b->contadores[c].load(memory_order_relaxed);
+}
+
+int64_t ahoraNs() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+               chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+BloqueInstrumentacion& bloqueDelHilo() {
+    if (!registrado) {
+        registrado = true;
+        thread_local BajaAlTerminar baja;
+        (void)baja;
+        Registro& r = registro();
+        lock_guard<mutex> candado(r.m);
+        r.vivos.push_back(&bloque);
+    }
+    return bloque;
+}
+
+ResumenInstrumentacion resumenInstrumentacion() {
+    Registro& r = registro();
+    lock_guard<mutex> candado(r.m);
+    ResumenInstrumentacion total = r.terminados;
+    for (const BloqueInstrumentacion* b : r.vivos) acumular(*b, total);
+    total.hilos += (int)r.vivos.size();
+
+    // Los bloques nunca se ponen en cero (solo los escribe su hilo): el
+    // reinicio guarda la suma de ese momento y se descuenta aquí
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c) total.contadores[c] -= r.base.contadores[c];
+    for (int f = 0; f < CANTIDAD_FASES; ++f) {
+        for (int c = 0; c < CANTIDAD_CONTADORES; ++c) total.contadoresFase[f][c] -= r.base.contadoresFase[f][c];
+        total.llamadas[f] -= r.base.llamadas[f];
+        total.nanosegundos[f] -= r.base.nanosegundos[f];
+    }
+    return total;
+}
+
+void reiniciarInstrumentacion() {
+    Registro& r = registro();
+    lock_guard<mutex> candado(r.m);
+    ResumenInstrumentacion total = r.terminados;
+    for (const BloqueInstrumentacion* b : r.vivos) acumular(*b, total);
+    r.base = total;
+}
+
+bool instrumentacionActiva() {
+#ifndef SIN_INSTRUMENTACION
+    return true;
+#else
+    return false;
+#endif
+}
+
+// ============================
+// Medición de fases
+// ============================
+// El hilo se registra antes de la foto: si no, sus reservas durante la
+// fase no entrarían en los totales
+MedicionFase::MedicionFase(Fase f) : fase(f) {
+    bloqueDelHilo();
+    totalesContadores(contadoresInicio);
+    inicio = ahoraNs();
+}
+
+MedicionFase::~MedicionFase() {
+    int64_t fin = ahoraNs();
+    uint64_t totales[CANTIDAD_CONTADORES];
+    totalesContadores(totales);
+    BloqueInstrumentacion& b = bloqueDelHilo();
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+        BloqueInstrumentacion::sumar(b.contadoresFase[fase][c], totales[c] - contadoresInicio[c]);
+    BloqueInstrumentacion::sumar(b.llamadas[fase], 1);
+    BloqueInstrumentacion::sumar(b.nanosegundos[fase], (uint64_t)(fin - inicio));
+}
+
+// ============================
+// Informes
+// ============================
+const char* nombreContador(Contador c) {
+    static const char* const nombres[CANTIDAD_CONTADORES] = {
+        "inserciones_cola", "extracciones_cola", "relajaciones", "entradas_viejas",
+        "ejecuciones_dijkstra", "bytes_leidos", "reservas", "bytes_reservados"};
+    return nombres[c];
+}
+
+const char* nombreFase(Fase f) {
+    static const char* const nombres[CANTIDAD_FASES] = {
+        "carga_texto", "carga_binario", "guardado", "instantanea", "todos_los_pares",
+        "reparacion", "mostrar_red", "ruta_mas_corta", "tablas", "exportacion", "jerarquia"};
+    return nombres[f];
+}
+
+void mostrarInstrumentacion(const ResumenInstrumentacion& r, ostream& out) {
+    if (!instrumentacionActiva()) {
+        out << "Instrumentación desactivada (compilado con SIN_INSTRUMENTACION).\n";
+        return;
+    }
+    out << "\n========= INSTRUMENTACIÓN (" << r.hilos << " hilos) =========\n";
+    out << "  Totales del proceso desde el inicio o el último reinicio:\n";
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+        out << "  " << left << setw(22) << nombreContador((Contador)c) << right << setw(16)
+            << r.contadores[c] << "\n";
+
+    out << "\n  " << left << setw(18) << "fase" << right << setw(10) << "llamadas"
+        << setw(14) << "total ms" << setw(14) << "media ms" << "\n";
+    out << fixed << setprecision(3);
+    for (int f = 0; f < CANTIDAD_FASES; ++f) {
+        if (r.llamadas[f] == 0) continue;
+        double ms = r.nanosegundos[f] / 1e6;
+        out << "  " << left << setw(18) << nombreFase((Fase)f) << right << setw(10) << r.llamadas[f]
+            << setw(14) << ms << setw(14) << ms / r.llamadas[f] << "\n";
+    }
+    out.unsetf(ios::fixed);
+
+    // Lo que crecieron los contadores mientras corría cada fase (incluye
+    // las fases anidadas y a los demás hilos del proceso)
+    out << "\n  Contadores durante cada fase (media por llamada):\n";
+    for (int f = 0; f < CANTIDAD_FASES; ++f) {
+        if (r.llamadas[f] == 0) continue;
+        out << "  " << nombreFase((Fase)f) << ":";
+        for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+            if (r.contadoresFase[f][c] != 0)
+                out << " " << nombreContador((Contador)c) << "=" << r.contadoresFase[f][c] / r.llamadas[f];
+        out << "\n";
+    }
+    out << "=================================================\n";
+}
+
+void volcarInstrumentacion(const ResumenInstrumentacion& r, ostream& out) {
+    out << "activa " << (instrumentacionActiva() ? 1 : 0) << "\n";
+    out << "hilos " << r.hilos << "\n";
+    for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+        out << "contador." << nombreContador((Contador)c) << " " << r.contadores[c] << "\n";
+    for (int f = 0; f < CANTIDAD_FASES; ++f) {
+        out << "fase." << nombreFase((Fase)f) << ".llamadas " << r.llamadas[f] << "\n";
+        out << "fase." << nombreFase((Fase)f) << ".ns " << r.nanosegundos[f] << "\n";
+        for (int c = 0; c < CANTIDAD_CONTADORES; ++c)
+            out << "fase." << nombreFase((Fase)f) << "." << nombreContador((Contador)c) << " "
+                << r.contadoresFase[f][c] << "\n";
+    }
+}
+
+// ============================
+// Conteo de reservas
+// ============================
+// Se reemplazan las formas básicas de operator new/delete; las de arreglos
+// y nothrow de la biblioteca estándar delegan en estas.
+#ifndef SIN_INSTRUMENTACION
+void* operator new(size_t tam) {
+    // Sin registrar el hilo (el registro mismo reserva memoria): los hilos
+    // que todavía no se registraron no cuentan, porque su bloque no entra
+    // en ningún informe y lo anotado aparecería de golpe al registrarse
+    if (registrado) {
+        BloqueInstrumentacion::sumar(bloque.contadores[RESERVAS], 1);
+        BloqueInstrumentacion::sumar(bloque.contadores[BYTES_RESERVADOS], tam);
+    }
+    if (void* p = malloc(tam ? tam : 1)) return p;
+    throw bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+#endif
@@ -0,0 +1,145 @@
+#ifndef INSTRUMENTACION_H
+#define INSTRUMENTACION_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// ===========================
+// Instrumentación de los caminos calientes
+// ===========================
+// Contadores de trabajo (inserciones y extracciones de las colas de
+// prioridad, relajaciones, entradas viejas descartadas, bytes leídos,
+// reservas de memoria) y tiempo de reloj por fase de cada operación de Red.
+//
+// Cada hilo escribe solo en su propio bloque (thread_local), sin
+// sincronización ni líneas de caché compartidas; los bloques se suman
+// recién al pedir el informe. Los núcleos de Dijkstra cuentan en
+// variables locales y suman una vez por llamada, no por arista.
+//
+// Los contadores generales son totales del proceso: suman el trabajo de
+// todas las operaciones y de todos los hilos desde el último reinicio.
+// Para atribuirlos a una operación, cada fase toma una foto de los totales
+// al empezar y al terminar y se queda con la diferencia (contadoresFase).
+// Como las fotos son de todo el proceso, la diferencia incluye lo que
+// hayan hecho otros hilos en ese lapso (p. ej. los trabajadores del
+// servidor); con el menú, que hace una operación por vez, es el trabajo de
+// esa operación y de los hilos que lanzó. Las fases anidadas también se
+// incluyen en la de afuera.
+//
+// Las reservas solo se cuentan en hilos ya registrados (los que midieron
+// o contaron algo al menos una vez) y desde ese momento.
+//
+// Compilando con SIN_INSTRUMENTACION (DEFINES += SIN_INSTRUMENTACION en
+// el .pro) las macros CONTAR y MEDIR_FASE no generan código y el informe
+// queda vacío.
+
+enum Contador {
+    INSERCIONES_COLA,      // montículo o cubetas de Dijkstra y de las reparaciones
+    EXTRACCIONES_COLA,
+    RELAJACIONES,          // aristas examinadas desde un nodo asentado
+    ENTRADAS_VIEJAS,       // extracciones descartadas por tener una distancia ya superada
+    EJECUCIONES_DIJKSTRA,
+    BYTES_LEIDOS,          // de archivos de topología
+    RESERVAS,              // llamadas a operator new de hilos registrados
+    BYTES_RESERVADOS,
+    CANTIDAD_CONTADORES
+};
+
+// Las fases anidadas (p. ej. TODOS_LOS_PARES dentro de MOSTRAR_RED) se
+// miden por separado: el tiempo de cada una es inclusivo.
+enum Fase {
+    FASE_CARGA_TEXTO,
+    FASE_CARGA_BINARIO,
+    FASE_GUARDADO,
+    FASE_INSTANTANEA,       // reconstrucción de la vista CSR
+    FASE_TODOS_LOS_PARES,
+    FASE_REPARACION,        // reparación incremental de la caché tras una edición
+    FASE_MOSTRAR_RED,
+    FASE_RUTA_MAS_CORTA,
+    FASE_TABLAS,
+    FASE_EXPORTACION,
+    FASE_JERARQUIA,         // construcción de la jerarquía de contracción
+    CANTIDAD_FASES
+};
+
+const char* nombreContador(Contador c);
+const char* nombreFase(Fase f);
+
+// Suma de todos los hilos desde el último reinicio
+struct ResumenInstrumentacion {
+    uint64_t contadores[CANTIDAD_CONTADORES] = {};
+    uint64_t contadoresFase[CANTIDAD_FASES][CANTIDAD_CONTADORES] = {};   // durante cada fase
+    uint64_t llamadas[CANTIDAD_FASES] = {};
+    uint64_t nanosegundos[CANTIDAD_FASES] = {};
+    int hilos = 0;          // hilos que registraron algo
+};
+
+// Bloque propio de un hilo. Solo lo escribe su hilo; los campos son
+// atómicos únicamente para que el informe pueda leerlos mientras tanto
+// (carga y guardado relajados: en x86 es una suma común).
+struct alignas(64) BloqueInstrumentacion {
+    std::atomic<uint64_t> contadores[CANTIDAD_CONTADORES];
+    std::atomic<uint64_t> contadoresFase[CANTIDAD_FASES][CANTIDAD_CONTADORES];
+    std::atomic<uint64_t> llamadas[CANTIDAD_FASES];
+    std::atomic<uint64_t> nanosegundos[CANTIDAD_FASES];
+
+    static void sumar(std::atomic<uint64_t>& campo, uint64_t x) {
+        campo.store(campo.load(std::memory_order_relaxed) + x, std::memory_order_relaxed);
+    }
+};
+
+BloqueInstrumentacion& bloqueDelHilo();
+
+ResumenInstrumentacion resumenInstrumentacion();
+void reiniciarInstrumentacion();   // el próximo resumen cuenta desde ahora
+bool instrumentacionActiva();      // false si se compiló con SIN_INSTRUMENTACION
+
+// Tabla legible y volcado "clave valor" por línea (contador.<nombre>,
+// fase.<nombre>.llamadas, fase.<nombre>.ns) para procesar con scripts
+void mostrarInstrumentacion(const ResumenInstrumentacion& resumen, std::ostream& salida);
+void volcarInstrumentacion(const ResumenInstrumentacion& resumen, std::ostream& salida);
+
+// Mide el tiempo de reloj de un ámbito y cuánto crecieron los contadores
+// del proceso mientras tanto
+class MedicionFase {
+public:
+    explicit MedicionFase(Fase fase);
+    ~MedicionFase();
+    MedicionFase(const MedicionFase&) = delete;
+    MedicionFase& operator=(const MedicionFase&) = delete;
+
+private:
+    Fase fase;
+    int64_t inicio;
+    uint64_t contadoresInicio[CANTIDAD_CONTADORES];
+};
+
+// Contadores de un recorrido en variables locales; se suman al bloque del
+// hilo una sola vez, al salir del ámbito
+struct ConteoRecorrido {
+    uint64_t inserciones = 0, extracciones = 0, relajaciones = 0, viejas = 0;
+
+    ~ConteoRecorrido() {
+#ifndef SIN_INSTRUMENTACION
+        BloqueInstrumentacion& b = bloqueDelHilo();
+        BloqueInstrumentacion::sumar(b.contadores[INSERCIONES_COLA], inserciones);
+        BloqueInstrumentacion::sumar(b.contadores[EXTRACCIONES_COLA], extracciones);
+        BloqueInstrumentacion::sumar(b.contadores[RELAJACIONES], relajaciones);
+        BloqueInstrumentacion::sumar(b.contadores[ENTRADAS_VIEJAS], viejas);
+#endif
+    }
+};
+
+#ifndef SIN_INSTRUMENTACION
+#define CONTAR(contador, cantidad) \
+    BloqueInstrumentacion::sumar(bloqueDelHilo().contadores[contador], (uint64_t)(cantidad))
+#define MEDIR_FASE_UNIR(a, b) a##b
+#define MEDIR_FASE_NOMBRE(linea) MEDIR_FASE_UNIR(medicionFase_, linea)
+#define MEDIR_FASE(fase) MedicionFase MEDIR_FASE_NOMBRE(__LINE__)(fase)
+#else
+#define CONTAR(contador, cantidad) ((void)0)
+#define MEDIR_FASE(fase) ((void)0)
+#endif
+
+#endif // INSTRUMENTACION_H
@@ -0,0 +1,471 @@
+#include "jerarquia.h"
+#include "formatobinario.h"
+#include "instrumentacion.h"
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cstdio>
+using namespace std;
+
+uint64_t huellaTopologia(const GrafoCSR& g) {
+    uint64_t h = 0xcbf29ce484222325ull ^ (uint64_t)g.cantidadNodos();
+    auto mezclar = [&](const Tramo<int>& arreglo) {
+        for (int x : arreglo) h = (h ^ (uint32_t)x) * 0x100000001b3ull;
+        h ^= h >> 29;
+    };
+    mezclar(g.ids);
+    mezclar(g.inicio);
+    mezclar(g.destino);
+    mezclar(g.costo);
+    return h;
+}
+
+// ============================
+// Construcción
+// ============================
+namespace {
+
+struct AristaDinamica {
+    int v;
+    int costo;
+    int medio;
+};
+
+const int ASENTADOS_SIMULACION = 60;   // tope de la búsqueda de testigos al estimar la prioridad
+const int ASENTADOS_CONTRACCION = 500; // tope al contraer de verdad
+// Si quedan más de NUCLEO_MAXIMO nodos y su grado medio pasa GRADO_NUCLEO
+// la red no tiene jerarquía aprovechable (p. ej. es aleatoria): seguir
+// solo agregaría atajos y el tiempo de construcción se dispararía
+const int GRADO_NUCLEO = 24;
+const int NUCLEO_MAXIMO = 256;
+const int GRADO_SIMULACION = 48;
+
+// Estado de la contracción: adyacencia de los nodos que quedan y búsqueda
+// de testigos (Dijkstra acotado que no pasa por el nodo que se contrae)
+class Contraccion {
+public:
+    explicit Contraccion(const GrafoCSR& g)
+        : n(g.cantidadNodos()), ady(n), contraidos(n, 0), nivel(n, 0),
+          prioridad(n, 0), dist(n, INFINITO), objetivo(n, false) {
+        for (int u = 0; u < n; ++u) {
+            ady[u].reserve(g.inicio[u + 1] - g.inicio[u]);
+            for (int k = g.inicio[u]; k < g.inicio[u + 1]; ++k)
+                if (g.destino[k] != u) ady[u].push_back({g.destino[k], g.costo[k], -1});
+            entradas += ady[u].size();
+        }
+    }
+
+    // Atajos que agregaría contraer v (y los agrega si 'aplicar')
+    int contraer(int v, bool aplicar) {
+        // Los atajos cambian la adyacencia de los vecinos, no la de v
+        const vector<AristaDinamica>& vecinos = ady[v];
+        int agregados = 0;
+        for (size_t i = 0; i + 1 < vecinos.size(); ++i) {
+            const AristaDinamica& a = vecinos[i];
+            int maximo = 0;
+            for (size_t j = i + 1; j < vecinos.size(); ++j) maximo = max(maximo, vecinos[j].costo);
+            for (size_t j = i + 1; j < vecinos.size(); ++j) objetivo[vecinos[j].v] = true;
+            testigos(a.v, v, a.costo + maximo, aplicar ? ASENTADOS_CONTRACCION : ASENTADOS_SIMULACION,
+                     (int)(vecinos.size() - i - 1));
+            for (size_t j = i + 1; j < vecinos.size(); ++j) objetivo[vecinos[j].v] = false;
+            for (size_t j = i + 1; j < vecinos.size(); ++j) {
+                const AristaDinamica& b = vecinos[j];
+                int costo = a.costo + b.costo;
+                if (dist[b.v] <= costo) continue; // hay un testigo: el atajo sobra
+                ++agregados;
+                if (aplicar) {
+                    agregarAtajo(a.v, b.v, costo, v);
+                    agregarAtajo(b.v, a.v, costo, v);
+                }
+            }
+        }
+        return agregados;
+    }
+
+    int calcularPrioridad(int v) {
+        int grado = (int)ady[v].size();
+        // Con muchos vecinos la simulación cuesta grado² búsquedas; se toma
+        // la cota (todos los pares), que igual lo deja para el final
+        int atajos = grado > GRADO_SIMULACION ? grado * (grado - 1) / 2 : contraer(v, false);
+        return 2 * (atajos - grado) + contraidos[v] + nivel[v];
+    }
+
+    // Quita v de la adyacencia de sus vecinos, que quedan con rango mayor
+    void retirar(int v) {
+        for (const AristaDinamica& a : ady[v]) {
+            auto& lista = ady[a.v];
+            for (size_t k = 0; k < lista.size(); ++k)
+                if (lista[k].v == v) {
+                    lista[k] = lista.back();
+                    lista.pop_back();
+                    break;
+                }
+            ++contraidos[a.v];
+            nivel[a.v] = max(nivel[a.v], nivel[v] + 1);
+        }
+        entradas -= 2 * ady[v].size();
+    }
+
+    int n;
+    vector<vector<AristaDinamica>> ady;
+    vector<int> contraidos;   // vecinos ya contraídos
+    vector<int> nivel;        // altura en la jerarquía, para repartir la contracción
+    vector<int> prioridad;
+    size_t entradas = 0;      // suma de los grados de los nodos que quedan
+
+private:
+    // Se detiene al asentar los 'objetivos' marcados, al pasar 'limite', al
+    // asentar maxAsentados nodos o al alcanzar 8 veces esa cantidad. Al
+    // simular no se expanden los nodos de grado alto (un concentrador no
+    // debe volver cara cada estimación). Cortar antes solo agrega atajos de
+    // más, nunca quita uno necesario
+    void testigos(int origen, int excluido, int limite, int maxAsentados, int objetivos) {
+        for (int t : tocados) dist[t] = INFINITO;
+        tocados.clear();
+        monticulo.clear();
+
+        greater<pair<int,int>> cmp;
+        dist[origen] = 0;
+        tocados.push_back(origen);
+        monticulo.push_back({0, origen});
+        int asentados = 0;
+        while (!monticulo.empty()) {
+            pop_heap(monticulo.begin(), monticulo.end(), cmp);
+            auto [d, u] = monticulo.back();
+            monticulo.pop_back();
+            if (d > dist[u]) continue;
+            if (d > limite || ++asentados > maxAsentados) break;
+            if (objetivo[u] && --objetivos == 0) break;
+            if (maxAsentados == ASENTADOS_SIMULACION && (int)ady[u].size() > GRADO_SIMULACION) continue;
+            for (const AristaDinamica& a : ady[u]) {
+                if (a.v == excluido) continue;
+                int nd = d + a.costo;
+                if (nd < dist[a.v]) {
+                    if (dist[a.v] == INFINITO) {
+                        if ((int)tocados.size() >= 8 * maxAsentados) return;
+                        tocados.push_back(a.v);
+                    }
+                    dist[a.v] = nd;
+                    monticulo.push_back({nd, a.v});
+                    push_heap(monticulo.begin(), monticulo.end(), cmp);
+                }
+            }
+        }
+    }
+
+    void agregarAtajo(int u, int w, int costo, int medio) {
+        for (AristaDinamica& a : ady[u])
+            if (a.v == w) {
+                if (costo < a.costo) {
+                    a.costo = costo;
+                    a.medio = medio;
+                }
+                return;
+            }
+        ady[u].push_back({w, costo, medio});
+        ++entradas;
+    }
+
+    vector<int> dist;
+    vector<char> objetivo;
+    vector<int> tocados;
+    vector<pair<int,int>> monticulo;
+};
+
+} // namespace
+
+bool JerarquiaContraccion::construir(const GrafoCSR& grafo) {
+    auto t0 = chrono::steady_clock::now();
+    g = grafo;
+    int n = g.cantidadNodos();
+    Contraccion c(g);
+
+    // Cola de prioridades con entradas perezosas: una entrada vale si su
+    // prioridad coincide con la vigente del nodo
+    greater<pair<int,int>> cmp;
+    vector<pair<int,int>> cola;
+    cola.reserve(n);
+    for (int v = 0; v < n; ++v) {
+        c.prioridad[v] = c.calcularPrioridad(v);
+        cola.push_back({c.prioridad[v], v});
+    }
+    make_heap(cola.begin(), cola.end(), cmp);
+
+    rango.assign(n, -1);
+    vector<vector<AristaDinamica>> subida(n);
+    int siguiente = 0;
+    while (!cola.empty()) {
+        int restantes = n - siguiente;
+        if (restantes > NUCLEO_MAXIMO && c.entradas > (size_t)GRADO_NUCLEO * restantes) {
+            *this = JerarquiaContraccion();
+            return false;
+        }
+
+        pop_heap(cola.begin(), cola.end(), cmp);
+        auto [p, v] = cola.back();
+        cola.pop_back();
+        if (rango[v] != -1 || p != c.prioridad[v]) continue;
+
+        // Actualización perezosa: si su prioridad real empeoró y ya no es la
+        // menor, vuelve a la cola
+        int actual = c.calcularPrioridad(v);
+        if (actual > p && !cola.empty() && actual > cola.front().first) {
+            c.prioridad[v] = actual;
+            cola.push_back({actual, v});
+            push_heap(cola.begin(), cola.end(), cmp);
+            continue;
+        }
+
+        c.contraer(v, true);
+        rango[v] = siguiente++;
+        subida[v] = c.ady[v];
+        c.retirar(v);
+        c.ady[v].clear();
+        c.ady[v].shrink_to_fit();
+
+        // Los vecinos cambiaron de grado: se recalcula su prioridad
+        for (const AristaDinamica& a : subida[v]) {
+            int q = c.calcularPrioridad(a.v);
+            if (q != c.prioridad[a.v]) {
+                c.prioridad[a.v] = q;
+                cola.push_back({q, a.v});
+                push_heap(cola.begin(), cola.end(), cmp);
+            }
+        }
+    }
+
+    // Grafo hacia arriba en CSR, cada lista ordenada por destino
+    inicio.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) inicio[v + 1] = inicio[v] + (int)subida[v].size();
+    destino.resize(inicio[n]);
+    costo.resize(inicio[n]);
+    medio.resize(inicio[n]);
+    for (int v = 0; v < n; ++v) {
+        auto& lista = subida[v];
+        sort(lista.begin(), lista.end(), [](const AristaDinamica& a, const AristaDinamica& b) { return a.v < b.v; });
+        for (size_t k = 0; k < lista.size(); ++k) {
+            destino[inicio[v] + k] = lista[k].v;
+            costo[inicio[v] + k] = lista[k].costo;
+            medio[inicio[v] + k] = lista[k].medio;
+        }
+        vector<AristaDinamica>().swap(lista);
+    }
+    atajos = count_if(medio.begin(), medio.end(), [](int m) { return m >= 0; });
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+// ============================
+// Consultas
+// ============================
+int JerarquiaContraccion::ruta(int origen, int destinoBuscado, vector<int>& camino, EspacioJerarquia& e) const {
+    int n = g.cantidadNodos();
+    camino.clear();
+    if (origen < 0 || destinoBuscado < 0 || origen >= n || destinoBuscado >= n) return INFINITO;
+    if (origen == destinoBuscado) {
+        camino.push_back(origen);
+        return 0;
+    }
+
+    for (int lado = 0; lado < 2; ++lado) {
+        if ((int)e.dist[lado].size() != n) {
+            e.dist[lado].assign(n, INFINITO);
+            e.padre[lado].assign(n, -1);
+        }
+        e.monticulo[lado].clear();
+    }
+    e.tocados.clear();
+
+    greater<pair<int,int>> cmp;
+    ConteoRecorrido conteo;
+    CONTAR(EJECUCIONES_DIJKSTRA, 1);
+    auto tocar = [&](int lado, int v, int d, int p) {
+        if (e.dist[0][v] == INFINITO && e.dist[1][v] == INFINITO) e.tocados.push_back(v);
+        e.dist[lado][v] = d;
+        e.padre[lado][v] = p;
+        e.monticulo[lado].push_back({d, v});
+        push_heap(e.monticulo[lado].begin(), e.monticulo[lado].end(), cmp);
+        ++conteo.inserciones;
+    };
+    tocar(0, origen, 0, -1);
+    tocar(1, destinoBuscado, 0, -1);
+
+    int mejor = INFINITO;
+    int encuentro = -1;
+    while (true) {
+        // Cada búsqueda sigue mientras su tope pueda mejorar el camino
+        bool activa[2];
+        for (int lado = 0; lado < 2; ++lado)
+            activa[lado] = !e.monticulo[lado].empty() && e.monticulo[lado].front().first < mejor;
+        if (!activa[0] && !activa[1]) break;
+        int lado = !activa[1] || (activa[0] && e.monticulo[0].front().first <= e.monticulo[1].front().first) ? 0 : 1;
+
+        auto& pq = e.monticulo[lado];
+        pop_heap(pq.begin(), pq.end(), cmp);
+        auto [d, u] = pq.back();
+        pq.pop_back();
+        ++conteo.extracciones;
+        if (d > e.dist[lado][u]) {
+            ++conteo.viejas;
+            continue;
+        }
+
+        int otra = e.dist[1 - lado][u];
+        if (otra != INFINITO && (long long)d + otra < mejor) {
+            mejor = d + otra;
+            encuentro = u;
+        }
+
+        // Parada a pedido: si un nodo más alto ya alcanzado llega a u más
+        // barato, u no está en un camino más corto que suba por aquí
+        bool detenido = false;
+        for (int k = inicio[u]; k < inicio[u + 1] && !detenido; ++k) {
+            int w = destino[k];
+            if (e.dist[lado][w] != INFINITO && (long long)e.dist[lado][w] + costo[k] < d) detenido = true;
+        }
+        if (detenido) continue;
+
+        conteo.relajaciones += inicio[u + 1] - inicio[u];
+        for (int k = inicio[u]; k < inicio[u + 1]; ++k) {
+            int w = destino[k];
+            int nd = d + costo[k];
+            if (nd < e.dist[lado][w]) tocar(lado, w, nd, u);
+        }
+    }
+
+    if (encuentro != -1) {
+        // Camino en la jerarquía: origen -> encuentro <- destino
+        e.subida.clear();
+        for (int x = encuentro; x != -1; x = e.padre[0][x]) e.subida.push_back(x);
+        reverse(e.subida.begin(), e.subida.end());
+        for (int x = e.padre[1][encuentro]; x != -1; x = e.padre[1][x]) e.subida.push_back(x);
+
+        camino.push_back(origen);
+        for (size_t i = 0; i + 1 < e.subida.size(); ++i) desarmar(e.subida[i], e.subida[i + 1], camino, e);
+    }
+
+    for (int v : e.tocados)
+        for (int lado = 0; lado < 2; ++lado) {
+            e.dist[lado][v] = INFINITO;
+            e.padre[lado][v] = -1;
+        }
+    return encuentro == -1 ? INFINITO : mejor;
+}
+
+// Agrega a 'camino' los nodos de desde -> hasta (sin 'desde') reemplazando
+// cada atajo por los dos tramos que une
+void JerarquiaContraccion::desarmar(int desde, int hasta, vector<int>& camino, EspacioJerarquia& e) const {
+    e.pila.clear();
+    e.pila.push_back({desde, hasta});
+    while (!e.pila.empty()) {
+        auto [a, b] = e.pila.back();
+        e.pila.pop_back();
+        // La arista la guarda el extremo de menor rango
+        int bajo = rango[a] < rango[b] ? a : b, alto = bajo == a ? b : a;
+        const int* fin = destino.data() + inicio[bajo + 1];
+        const int* it = lower_bound(destino.data() + inicio[bajo], fin, alto);
+        int m = it != fin && *it == alto ? medio[it - destino.data()] : -1;
+        if (m < 0) {
+            camino.push_back(b);
+            continue;
+        }
+        e.pila.push_back({m, b});
+        e.pila.push_back({a, m});
+    }
+}
+
+// ============================
+// Archivo
+// ============================
+// Como guardarBinario: se escribe al lado y se renombra, porque la
+// jerarquía mantiene viva su instantánea (que puede estar mapeada del
+// mismo directorio) y un error no debe dejar el archivo anterior a medias
+bool JerarquiaContraccion::guardar(const string& ruta) const {
+    string temporal = ruta + ".tmp";
+    ofstream archivo(temporal, ios::binary | ios::trunc);
+    if (!archivo.is_open()) {
+        cerr << "Error al abrir/crear archivo: " << temporal << endl;
+        return false;
+    }
+
+    CabeceraJerarquia c{};
+    memcpy(c.magia, MAGIA_JERARQUIA, sizeof(c.magia));
+    c.version = VERSION_JERARQUIA;
+    c.marcaOrden = MARCA_ORDEN;
+    c.nodos = g.cantidadNodos();
+    c.aristas = destino.size();
+    c.huella = huellaTopologia(g);
+
+    archivo.write((const char*)&c, sizeof(c));
+    archivo.write((const char*)rango.data(), 4ull * rango.size());
+    archivo.write((const char*)inicio.data(), 4ull * inicio.size());
+    archivo.write((const char*)destino.data(), 4ull * destino.size());
+    archivo.write((const char*)costo.data(), 4ull * costo.size());
+    archivo.write((const char*)medio.data(), 4ull * medio.size());
+
+    archivo.close();
+    if (!archivo) {
+        cerr << "Error al escribir: " << temporal << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+    if (rename(temporal.c_str(), ruta.c_str()) != 0) {
+        cerr << "Error al reemplazar: " << ruta << endl;
+        remove(temporal.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool JerarquiaContraccion::cargar(const string& ruta, const GrafoCSR& grafo) {
+    ifstream archivo(ruta, ios::binary | ios::ate);
+    if (!archivo.is_open()) return false;
+    uint64_t tamano = (uint64_t)archivo.tellg();
+    archivo.seekg(0);
+    CabeceraJerarquia c{};
+    if (!archivo.read((char*)&c, sizeof(c))) return false;
+    int n = grafo.cantidadNodos();
+    if (memcmp(c.magia, MAGIA_JERARQUIA, sizeof(c.magia)) != 0 || c.version != VERSION_JERARQUIA ||
+        c.marcaOrden != MARCA_ORDEN || c.nodos != (uint32_t)n || c.aristas > INT_MAX ||
+        c.huella != huellaTopologia(grafo))
+        return false;
+    // El largo se controla antes de reservar los arreglos
+    if (tamano != sizeof(c) + 4ull * (2ull * n + 1) + 12ull * c.aristas) return false;
+
+    auto leer = [&](vector<int>& arreglo, size_t cantidad) {
+        arreglo.resize(cantidad);
+        return (bool)archivo.read((char*)arreglo.data(), 4ull * cantidad);
+    };
+    if (!leer(rango, n) || !leer(inicio, n + 1) || !leer(destino, c.aristas) ||
+        !leer(costo, c.aristas) || !leer(medio, c.aristas))
+        return false;
+
+    // Un archivo dañado no debe llevar a índices fuera de rango ni a una
+    // consulta que no termina. Se exige lo que garantiza la construcción:
+    // los rangos son una permutación, cada arista sube de rango, las filas
+    // están ordenadas (desarmar las busca con lower_bound) y el nodo medio de
+    // un atajo tiene rango menor que sus dos extremos, así cada paso de
+    // desarmar baja de rango y termina
+    bool valido = inicio[0] == 0 && inicio[n] == (int)c.aristas;
+    vector<char> visto(n, 0);
+    for (int v = 0; v < n && valido; ++v) {
+        valido = inicio[v] <= inicio[v + 1] && rango[v] >= 0 && rango[v] < n && !visto[rango[v]];
+        if (valido) visto[rango[v]] = 1;
+    }
+    for (int v = 0; v < n && valido; ++v) {
+        for (int k = inicio[v]; k < inicio[v + 1] && valido; ++k) {
+            int w = destino[k], m = medio[k];
+            valido = w >= 0 && w < n && rango[w] > rango[v] && costo[k] >= 0 &&
+                     (k == inicio[v] || w > destino[k - 1]) &&
+                     (m == -1 || (m >= 0 && m < n && rango[m] < rango[v]));
+        }
+    }
+    if (!valido) return false;
+
+    g = grafo;
+    atajos = count_if(medio.begin(), medio.end(), [](int m) { return m >= 0; });
+    ms = 0;
+    return true;
+}
@@ -0,0 +1,98 @@
+#ifndef JERARQUIA_H
+#define JERARQUIA_H
+
+#include "grafocsr.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+// ===========================
+// Jerarquía de contracción
+// ===========================
+// Preprocesa una instantánea para responder consultas punto a punto sin
+// recorrer casi toda la red. Los nodos se contraen de a uno, primero los
+// menos importantes (los que agregan menos atajos de los enlaces que
+// quitan). Al contraer v, cada par de vecinos u, w todavía sin contraer
+// cuyo único camino más corto conocido pasa por v recibe un atajo u - w
+// de costo c(u,v) + c(v,w); una búsqueda de testigos acotada evita los
+// atajos innecesarios.
+//
+// Cada nodo guarda solo los enlaces y atajos hacia nodos de rango mayor.
+// Una consulta son dos búsquedas de Dijkstra que solo suben de rango (una
+// desde cada extremo) y se cruzan en el nodo más alto del camino; después
+// los atajos se desarman en los enlaces originales.
+//
+// La jerarquía corresponde a una instantánea fija: cualquier edición de la
+// red la deja vieja (se compara el almacen, como con las FIB). En disco va
+// con una huella de la topología, así que un archivo de otra versión de la
+// red se descarta al cargarlo.
+//
+//   CabeceraJerarquia                    48 bytes
+//   int32 rango[nodos]
+//   int32 inicio[nodos + 1]
+//   int32 destino[aristas]
+//   int32 costo[aristas]
+//   int32 medio[aristas]                 -1 si es un enlace original
+const char MAGIA_JERARQUIA[8] = {'R', 'E', 'D', 'C', 'H', '\0', '\0', '\0'};
+const uint32_t VERSION_JERARQUIA = 1;
+
+struct CabeceraJerarquia {
+    char magia[8];
+    uint32_t version;
+    uint32_t marcaOrden;
+    uint32_t nodos;
+    uint32_t reservado;
+    uint64_t aristas;
+    uint64_t huella;          // de la topología sobre la que se construyó
+    uint64_t reservado2;
+};
+static_assert(sizeof(CabeceraJerarquia) == 48, "la cabecera de la jerarquía debe ocupar 48 bytes");
+
+// Memoria de trabajo de las consultas, reutilizable entre llamadas (una por hilo)
+struct EspacioJerarquia {
+    std::vector<int> dist[2];
+    std::vector<int> padre[2];
+    std::vector<std::pair<int,int>> monticulo[2];
+    std::vector<int> tocados;
+    std::vector<std::pair<int,int>> pila;
+    std::vector<int> subida;
+};
+
+class JerarquiaContraccion {
+public:
+    // false si la red no tiene una jerarquía aprovechable: en redes sin
+    // estructura (p. ej. aleatorias) los atajos se multiplican al contraer y
+    // la construcción se abandona antes de que se dispare
+    bool construir(const GrafoCSR& grafo);
+
+    bool guardar(const std::string& ruta) const;
+    // false si el archivo no existe, está dañado o es de otra topología
+    bool cargar(const std::string& ruta, const GrafoCSR& grafo);
+
+    const GrafoCSR& grafo() const { return g; }
+    size_t cantidadAtajos() const { return atajos; }
+    size_t cantidadAristas() const { return destino.size(); }
+    double msConstruccion() const { return ms; }
+
+    // Devuelve el costo mínimo (INFINITO si no hay ruta) y deja en 'camino'
+    // los índices origen -> ... -> destino.
+    int ruta(int origen, int destino, std::vector<int>& camino, EspacioJerarquia& espacio) const;
+
+private:
+    void desarmar(int desde, int hasta, std::vector<int>& camino, EspacioJerarquia& e) const;
+
+    GrafoCSR g;
+    std::vector<int> rango;
+    std::vector<int> inicio;      // aristas de cada nodo hacia nodos de rango mayor,
+    std::vector<int> destino;     // ordenadas por destino
+    std::vector<int> costo;
+    std::vector<int> medio;       // nodo contraído que reemplaza el atajo (-1 = enlace original)
+    size_t atajos = 0;
+    double ms = 0;
+};
+
+// Huella de la topología (ids, adyacencia y costos) para reconocer archivos viejos
+uint64_t huellaTopologia(const GrafoCSR& grafo);
+
+#endif // JERARQUIA_H
@@ -0,0 +1,222 @@
+#include "lote.h"
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <algorithm>
+using namespace std;
+
+// Consultas acumuladas antes de resolverlas aunque no llegue una edición
+static const size_t MAX_CONSULTAS_TRAMO = 1 << 20;
+
+struct Consulta {
+    int origen;    // ids tal como llegaron; al resolver, índices (origen -1 = inválida)
+    int destino;
+    bool conCamino;
+    long long linea;
+};
+
+// Dónde quedó el texto de la respuesta de cada consulta
+struct Respuesta {
+    int hilo = -1;  // -1 = consulta inválida, sin respuesta
+    size_t inicio = 0;
+    size_t largo = 0;
+};
+
+// ============================
+// Lectura de órdenes
+// ============================
+static string_view siguientePalabra(string_view& resto) {
+    size_t i = resto.find_first_not_of(" \t\r");
+    if (i == string_view::npos) { resto = {}; return {}; }
+    resto.remove_prefix(i);
+    size_t j = resto.find_first_of(" \t\r");
+    string_view palabra = resto.substr(0, j);
+    resto.remove_prefix(j == string_view::npos ? resto.size() : j);
+    return palabra;
+}
+
+// Acepta "5" o "R5"
+static bool leerEntero(string_view& resto, int& valor, bool admiteR) {
+    string_view p = siguientePalabra(resto);
+    if (admiteR && !p.empty() && (p[0] == 'R' || p[0] == 'r')) p.remove_prefix(1);
+    if (p.empty()) return false;
+    auto [fin, ec] = from_chars(p.data(), p.data() + p.size(), valor);
+    return ec == errc() && fin == p.data() + p.size();
+}
+
+// ============================
+// Resolución de un tramo de consultas
+// ============================
+static char* escribirNombre(char* p, int id) {
+    *p++ = 'R';
+    return to_chars(p, p + 12, id).ptr;
+}
+
+static void resolverTramo(Red& red, vector<Consulta>& consultas, ostream& salida,
+                          EstadisticasLote& est) {
+    if (consultas.empty()) return;
+
+    GrafoCSR g = red.instantanea();
+    PoolHilos& pool = red.obtenerPool();
+    int n = g.cantidadNodos();
+    int hilos = pool.cantidadHilos();
+
+    vector<Respuesta> respuestas(consultas.size());
+
+    // Agrupar por origen con un conteo: orden[] queda ordenado por origen
+    vector<int> inicioOrigen(n + 1, 0);
+    bool algunCamino = false;
+    for (Consulta& c : consultas) {
+        int o = indiceDeId(g, c.origen), d = indiceDeId(g, c.destino);
+        if (o < 0 || d < 0) {
+            cerr << "Línea " << c.linea << ": ID inválido (R" << c.origen << " R" << c.destino << ").\n";
+            ++est.errores;
+            c.origen = -1; // queda sin respuesta
+            continue;
+        }
+        c.origen = o;
+        c.destino = d;
+        ++inicioOrigen[o + 1];
+        algunCamino |= c.conCamino;
+    }
+    for (int i = 0; i < n; ++i) inicioOrigen[i + 1] += inicioOrigen[i];
+    vector<int> orden(inicioOrigen[n]);
+    {
+        vector<int> pos(inicioOrigen.begin(), inicioOrigen.end() - 1);
+        for (size_t q = 0; q < consultas.size(); ++q)
+            if (consultas[q].origen >= 0)
+                orden[pos[consultas[q].origen]++] = (int)q;
+    }
+
+    vector<int> origenes;
+    for (int i = 0; i < n; ++i)
+        if (inicioOrigen[i + 1] > inicioOrigen[i]) origenes.push_back(i);
+    est.arboles += origenes.size();
+
+    // Memoria propia de cada hilo: un árbol y un búfer de texto
+    struct EspacioHilo {
+        vector<int> dist, prev, camino;
+        EspacioDijkstra dijkstra;
+        string texto;
+    };
+    vector<EspacioHilo> espacios(hilos);
+
+    pool.paraCada((int)origenes.size(), [&](int k, int hilo) {
+        EspacioHilo& e = espacios[hilo];
+        int o = origenes[k];
+        e.dist.resize(n);
+        if (algunCamino) e.prev.resize(n);
+        dijkstra(g, o, e.dist.data(), algunCamino ? e.prev.data() : nullptr, e.dijkstra);
+
+        char numero[16];
+        for (int t = inicioOrigen[o]; t < inicioOrigen[o + 1]; ++t) {
+            int q = orden[t];
+            int d = consultas[q].destino;
+            size_t inicio = e.texto.size();
+
+            e.texto.append(numero, escribirNombre(numero, g.ids[o]));
+            e.texto.push_back(' ');
+            e.texto.append(numero, escribirNombre(numero, g.ids[d]));
+            e.texto.push_back(' ');
+            if (e.dist[d] == INFINITO) {
+                e.texto.push_back('-');
+            } else {
+                e.texto.append(numero, to_chars(numero, numero + 16, e.dist[d]).ptr);
+                if (consultas[q].conCamino) {
+                    e.camino.clear();
+                    for (int cur = d; cur != -1 && cur != o; cur = e.prev[cur])
+                        e.camino.push_back(cur);
+                    e.camino.push_back(o);
+                    for (auto it = e.camino.rbegin(); it != e.camino.rend(); ++it) {
+                        e.texto.push_back(' ');
+                        e.texto.append(numero, escribirNombre(numero, g.ids[*it]));
+                    }
+                }
+            }
+            e.texto.push_back('\n');
+            respuestas[q] = {hilo, inicio, e.texto.size() - inicio};
+        }
+    });
+
+    // Volcado en el orden de entrada
+    for (const Respuesta& r : respuestas)
+        if (r.hilo != -1) salida.write(espacios[r.hilo].texto.data() + r.inicio, r.largo);
+
+    est.consultas += orden.size();
+    consultas.clear();
+}
+
+// ============================
+// Bucle principal
+// ============================
+void procesarLote(Red& red, istream& entrada, ostream& salida, EstadisticasLote* estadisticas) {
+    EstadisticasLote est;
+    vector<Consulta> consultas;
+    string linea;
+    long long numero = 0;
+
+    auto error = [&](const char* mensaje) {
+        cerr << "Línea " << numero << ": " << mensaje << "\n";
+        ++est.errores;
+    };
+
+    while (getline(entrada, linea)) {
+        ++numero;
+        string_view resto = linea;
+        string_view orden = siguientePalabra(resto);
+        if (orden.empty() || orden[0] == '#') continue;
+
+        if (orden == "ruta" || orden == "costo") {
+            Consulta c{0, 0, orden == "ruta", numero};
+            if (!leerEntero(resto, c.origen, true) || !leerEntero(resto, c.destino, true)) {
+                error("se esperaba 'ruta|costo ORIGEN DESTINO'.");
+                continue;
+            }
+            consultas.push_back(c);
+            if (consultas.size() >= MAX_CONSULTAS_TRAMO)
+                resolverTramo(red, consultas, salida, est);
+            continue;
+        }
+
+        // Cualquier edición cierra el tramo: las consultas previas ven la red anterior
+        resolverTramo(red, consultas, salida, est);
+
+        int a, b, costo;
+        bool ok;
+        if (orden == "enlace") {
+            if (!leerEntero(resto, a, true) || !leerEntero(resto, b, true) || !leerEntero(resto, costo, false)) {
+                error("se esperaba 'enlace A B COSTO'.");
+                continue;
+            }
+            ok = red.conectar(a, b, costo);
+        } else if (orden == "quitar") {
+            if (!leerEntero(resto, a, true) || !leerEntero(resto, b, true)) {
+                error("se esperaba 'quitar A B'.");
+                continue;
+            }
+            ok = red.desconectar(a, b);
+        } else if (orden == "nuevo") {
+            red.crearEnrutador();
+            ok = true;
+        } else if (orden == "borrar") {
+            if (!leerEntero(resto, a, true)) {
+                error("se esperaba 'borrar ID'.");
+                continue;
+            }
+            ok = red.quitarEnrutador(a);
+        } else {
+            error("orden desconocida.");
+            continue;
+        }
+
+        if (ok) ++est.ediciones;
+        else error("edición rechazada (IDs o costo inválidos).");
+    }
+    resolverTramo(red, consultas, salida, est);
+    salida.flush();
+
+    if (estadisticas) *estadisticas = est;
+}
@@ -0,0 +1,41 @@
+#ifndef LOTE_H
+#define LOTE_H
+
+#include "red.h"
+#include <iostream>
+
+// ===========================
+// Consultas por lotes, sin menú
+// ===========================
+// Lee una secuencia de órdenes, una por línea (las vacías y las que
+// empiezan con # se ignoran; los ids se aceptan como 5 o R5):
+//
+//   ruta O D          costo y camino de O a D
+//   costo O D         solo el costo
+//   enlace A B C      crea el enlace A - B o cambia su costo
+//   quitar A B        elimina el enlace A - B
+//   nuevo             agrega un enrutador aislado
+//   borrar ID         elimina un enrutador (los demás conservan su id)
+//
+// Las consultas se acumulan hasta la próxima edición y se resuelven juntas:
+// se agrupan por origen, cada árbol de rutas más cortas se calcula una sola
+// vez (los orígenes se reparten en el pool de hilos) y sirve a todos los
+// destinos que lo comparten. Las respuestas salen en el orden de entrada,
+// una línea por consulta:
+//
+//   R1 R5 12 R1 R3 R5     ruta
+//   R1 R5 12              costo
+//   R1 R5 -               sin ruta
+//
+// Las líneas con errores se informan por cerr con su número y se omiten.
+struct EstadisticasLote {
+    long long consultas = 0;
+    long long ediciones = 0;
+    long long arboles = 0;       // árboles de rutas calculados (orígenes distintos por tramo)
+    long long errores = 0;
+};
+
+void procesarLote(Red& red, std::istream& entrada, std::ostream& salida,
+                  EstadisticasLote* estadisticas = nullptr);
+
+#endif // LOTE_H
@@ -1,8 +1,16 @@
 #include "red.h"
+#include "formatobinario.h"
+#include "lote.h"
+#include "instrumentacion.h"
+#include "servidor.h"
+#include "catalogo.h"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <limits>
-#include <QDir>
-#include <QFile>
+#include <cstdlib>
+#include <chrono>
+#include <ctime>
 
 using namespace std;
 
@@ -19,64 +27,55 @@ void mostrarMenu() {
     cout << "7. Guardar red\n";
     cout << "8. Mostrar tablas de enrutamiento\n";
     cout << "9. Salir\n";
+    cout << "10. Simular vector distancia (RIP)\n";
+    cout << "11. Simular estado de enlace (OSPF)\n";
+    cout << "12. Simular tráfico (reenvío de paquetes)\n";
+    cout << "13. Exportar matriz o tablas (CSV o binario)\n";
+    cout << "14. Estadísticas de instrumentación\n";
+    cout << "15. Preparar jerarquía de contracción (rutas rápidas)\n";
     cout << "=========================================\n";
     cout << "Seleccione una opción: ";
 }
 
 /**
- * @brief Cuenta cuántos archivos red_*.txt existen en la carpeta.
+ * @brief Lista las redes del catálogo con su número, tamaño y nombre.
+ * @return false si no hay redes guardadas
  */
-int contarRedesDisponibles(const string& carpeta) {
-    QDir dir(QString::fromStdString(carpeta));
-
-    if (!dir.exists()) {
-        dir.mkpath(".");
-        return 0;
+bool listarRedesDisponibles(const CatalogoRedes& catalogo) {
+    if (catalogo.redes().empty()) {
+        cout << "No hay redes guardadas disponibles.\n";
+        return false;
     }
 
-    QStringList filtros;
-    filtros << "red_*.txt";
-    dir.setNameFilters(filtros);
-    dir.setFilter(QDir::Files);
-
-    return dir.entryList().size();
+    cout << "\nRedes disponibles:\n";
+    for (const RedCatalogada& red : catalogo.redes()) {
+        cout << "  [" << red.numero << "] " << red.nombre << " (" << red.nodos
+             << " enrutadores, " << red.enlaces << " enlaces)\n";
+    }
+    return true;
 }
 
 /**
- * @brief Lista las redes disponibles en la carpeta.
+ * @brief Pide el número de una red del catálogo.
+ * @return La red elegida, o nullptr si el número no está
  */
-vector<string> listarRedesDisponibles(const string& carpeta) {
-    vector<string> archivos;
-    int cantidad = contarRedesDisponibles(carpeta);
-
-    if (cantidad == 0) {
-        cout << "No hay redes guardadas disponibles.\n";
-        return archivos;
+const RedCatalogada* elegirRed(const CatalogoRedes& catalogo, const string& mensaje) {
+    cout << mensaje;
+    int eleccion;
+    cin >> eleccion;
+    if (cin.fail()) {
+        cin.clear();
+        eleccion = 0;
     }
-
-    cout << "\nRedes disponibles:\n";
-
-    // Listar red_1.txt, red_2.txt, ... red_n.txt
-    QDir dir(QString::fromStdString(carpeta));
-    for (int i = 1; i <= cantidad; ++i) {
-        string nombreArchivo = "red_" + to_string(i) + ".txt";
-        QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-
-        // Verificar si el archivo existe
-        if (QFile::exists(rutaCompleta)) {
-            archivos.push_back(nombreArchivo);
-            cout << "  [" << i << "] " << nombreArchivo << "\n";
-        }
-    }
-
-    return archivos;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    return catalogo.buscar(eleccion);
 }
 
 /**
  * @brief Solicita al usuario cómo desea guardar la red.
  * @return Ruta completa del archivo donde guardar
  */
-string solicitarRutaGuardado(const string& carpeta) {
+string solicitarRutaGuardado(const CatalogoRedes& catalogo) {
     cout << "\n¿Cómo desea guardar la red?\n";
     cout << "1. Crear archivo nuevo\n";
     cout << "2. Sobreescribir archivo existente\n";
@@ -86,47 +85,29 @@ string solicitarRutaGuardado(const string& carpeta) {
     cin >> opcion;
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
-    QDir dir(QString::fromStdString(carpeta));
-
     if (opcion == 1) {
-        // Crear archivo nuevo con el siguiente número disponible
-        int cantidadActual = contarRedesDisponibles(carpeta);
-        int nuevoNumero = cantidadActual + 1;
-
-        string nombreArchivo = "red_" + to_string(nuevoNumero) + ".txt";
-        QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-
-        cout << "Nueva red será guardada como: " << nombreArchivo << "\n";
-        return rutaCompleta.toStdString();
+        // Crear archivo nuevo con el siguiente número del catálogo
+        string ruta = catalogo.rutaNueva();
+        cout << "Nueva red será guardada como: " << ruta << "\n";
+        return ruta;
 
     } else if (opcion == 2) {
         // Sobreescribir archivo existente
-        vector<string> disponibles = listarRedesDisponibles(carpeta);
-
-        if (disponibles.empty()) {
+        if (!listarRedesDisponibles(catalogo)) {
             cout << "No hay archivos existentes para sobreescribir.\n";
             cout << "Creando archivo nuevo...\n";
-
-            string nombreArchivo = "red_1.txt";
-            QString rutaCompleta = dir.filePath(QString::fromStdString(nombreArchivo));
-            return rutaCompleta.toStdString();
+            return catalogo.rutaNueva();
         }
 
-        cout << "Seleccione el número del archivo a sobreescribir: ";
-        int eleccion;
-        cin >> eleccion;
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-        if (eleccion > 0 && eleccion <= (int)disponibles.size()) {
-            cout << "¿Está seguro de sobreescribir '" << disponibles[eleccion - 1]
-                 << "'? (s/n): ";
+        const RedCatalogada* red = elegirRed(catalogo, "Seleccione el número del archivo a sobreescribir: ");
+        if (red) {
+            cout << "¿Está seguro de sobreescribir '" << red->nombre << "'? (s/n): ";
             char confirmar;
             cin >> confirmar;
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
             if (confirmar == 's' || confirmar == 'S') {
-                QString rutaCompleta = dir.filePath(QString::fromStdString(disponibles[eleccion - 1]));
-                return rutaCompleta.toStdString();
+                return catalogo.ruta(*red);
             } else {
                 cout << "Operación cancelada.\n";
                 return "";
@@ -141,9 +122,414 @@ string solicitarRutaGuardado(const string& carpeta) {
     }
 }
 
+/**
+ * @brief Guarda la red y, si se pudo, la anota en el catálogo.
+ * @return false si no se pudo guardar
+ */
+bool guardarRed(const Red& red, CatalogoRedes& catalogo, const string& ruta) {
+    if (!red.guardarEnArchivo(ruta)) return false;
+    catalogo.registrar(ruta, red.instantanea());
+    return true;
+}
+
+/**
+ * @brief Carga una red del catálogo. Si el archivo cambió desde que se
+ * anotó, avisa y actualiza la entrada; si ya no existe, la quita.
+ * @return false si no se pudo cargar
+ */
+bool abrirRed(Red& red, CatalogoRedes& catalogo, const RedCatalogada& entrada) {
+    string ruta = catalogo.ruta(entrada);
+    int numero = entrada.numero;
+    if (!catalogo.verificar(entrada)) {
+        ifstream existe(ruta);
+        if (!existe.is_open()) {
+            cout << "El archivo " << ruta << " ya no existe; se quita del catálogo.\n";
+            catalogo.quitar(numero);
+            return false;
+        }
+        cout << "El archivo " << ruta << " cambió desde que se guardó.\n";
+        if (!red.cargarDesdeArchivo(ruta)) return false;
+        cout << "Se actualiza el catálogo.\n";
+        catalogo.registrar(ruta, red.instantanea());
+    } else if (!red.cargarDesdeArchivo(ruta)) {
+        return false;
+    }
+    cout << "Red " << numero << " cargada correctamente.\n";
+    return true;
+}
+
+/**
+ * @brief Lee una línea con IDs separados por espacios o comas (se aceptan
+ * "5" y "R5"). Una línea vacía da una lista vacía.
+ */
+vector<int> leerIds(const string& mensaje) {
+    cout << mensaje;
+    string linea;
+    getline(cin, linea);
+    for (char& c : linea)
+        if (c == ',' || c == 'R' || c == 'r') c = ' ';
+    vector<int> ids;
+    istringstream entrada(linea);
+    int id;
+    while (entrada >> id) ids.push_back(id);
+    return ids;
+}
+
+/**
+ * @brief Pregunta el modelo de topología y sus parámetros y genera la red.
+ * Con semilla 0 se usa el reloj; la semilla usada se informa para poder repetir la red.
+ * @return La red nueva, o nullptr si los datos no son válidos
+ */
+Red* generarRedNueva(int hilos, uint64_t semilla) {
+    if (semilla == 0) semilla = (uint64_t)time(nullptr);
+
+    cout << "\nTipo de red:\n";
+    cout << "1. Completa (todos los pares)\n";
+    cout << "2. Aleatoria dispersa (Erdős–Rényi)\n";
+    cout << "3. Libre de escala (Barabási–Albert)\n";
+    cout << "4. Malla\n";
+    cout << "5. Fat-tree\n";
+    cout << "Seleccione una opción: ";
+    int tipo;
+    cin >> tipo;
+
+    ParametrosTopologia p;
+    p.semilla = semilla;
+    if (tipo == 5) {
+        p.modelo = ModeloTopologia::FatTree;
+        cout << "Ingrese k (puertos por conmutador, par): ";
+        cin >> p.k;
+    } else if (tipo >= 1 && tipo <= 4) {
+        cout << "Ingrese la cantidad de enrutadores para la nueva red: ";
+        cin >> p.nodos;
+        if (tipo == 2) {
+            p.modelo = ModeloTopologia::ErdosRenyi;
+            cout << "Ingrese el grado medio: ";
+            cin >> p.gradoMedio;
+        } else if (tipo == 3) {
+            p.modelo = ModeloTopologia::BarabasiAlbert;
+            cout << "Ingrese los enlaces por enrutador nuevo: ";
+            cin >> p.enlacesPorNodo;
+        } else if (tipo == 4) {
+            p.modelo = ModeloTopologia::Malla;
+            cout << "Ingrese la cantidad de columnas (0 = cuadrada): ";
+            cin >> p.columnas;
+        }
+    } else {
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Opción inválida.\n";
+        return nullptr;
+    }
+
+    if (tipo != 1) {
+        cout << "Costos (1. uniforme, 2. exponencial, 3. constante): ";
+        int distribucion;
+        cin >> distribucion;
+        if (distribucion == 2) p.costo.tipo = DistribucionCosto::Exponencial;
+        if (distribucion == 3) p.costo.tipo = DistribucionCosto::Constante;
+        cout << "Ingrese el costo mínimo y el máximo: ";
+        cin >> p.costo.minimo >> p.costo.maximo;
+    }
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Entrada inválida.\n";
+        return nullptr;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    Red* red;
+    if (tipo == 1) {
+        red = new Red(p.nodos);
+        red->setHilos(hilos);
+        red->generarRedAleatoria(semilla);
+    } else {
+        red = new Red();
+        red->setHilos(hilos);
+        if (!red->generarTopologia(p)) {
+            delete red;
+            return nullptr;
+        }
+    }
+    cout << "Semilla: " << semilla << "\n";
+    return red;
+}
+
+/**
+ * @brief Pide las opciones del protocolo, corre la simulación de vector
+ * distancia y ofrece mostrar las tablas resultantes.
+ */
+void simularVectorDistancia(Red& red) {
+    ConfiguracionVD config;
+    char respuesta;
+    cout << "¿Usar horizonte dividido con envenenamiento en reversa? (s/n): ";
+    cin >> respuesta;
+    config.horizonteDividido = respuesta == 's' || respuesta == 'S';
+    cout << "Costo considerado infinito (0 = 16 veces el costo máximo): ";
+    cin >> config.infinito;
+    if (cin.fail()) {
+        cin.clear();
+        config.infinito = 0;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    red.simularVectorDistancia(config);
+
+    cout << "¿Mostrar las tablas de cada enrutador? (s/n): ";
+    cin >> respuesta;
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+    if (respuesta == 's' || respuesta == 'S') red.mostrarTablasVectorDistancia();
+}
+
+/**
+ * @brief Pide los retardos del protocolo y activa la simulación de estado
+ * de enlace para las ediciones siguientes.
+ */
+void simularEstadoEnlace(Red& red) {
+    ConfiguracionLS config;
+    cout << "Retardo por unidad de costo y de procesamiento por salto, en ms (ej. 1 0.5): ";
+    cin >> config.retardoPorCosto >> config.procesamiento;
+    cout << "Espera inicial del SPF y separación mínima entre SPF, en ms (ej. 50 200): ";
+    cin >> config.spfRetardo >> config.spfEspera;
+    if (cin.fail() || config.retardoPorCosto < 0 || config.procesamiento < 0 ||
+        config.spfRetardo < 0 || config.spfEspera < 0) {
+        cin.clear();
+        cout << "Valores inválidos, se usan los predeterminados.\n";
+        config = ConfiguracionLS();
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    red.simularEstadoEnlace(config);
+}
+
+/**
+ * @brief Pide la cantidad de paquetes y el TTL y reenvía tráfico sintético
+ * por las FIB de los enrutadores.
+ */
+void simularTrafico(Red& red, uint64_t semilla) {
+    ConfiguracionTrafico config;
+    config.semilla = semilla != 0 ? semilla : (uint64_t)time(nullptr);
+    cout << "Cantidad de paquetes: ";
+    cin >> config.paquetes;
+    cout << "TTL (0 = cantidad de enrutadores): ";
+    cin >> config.ttl;
+    if (cin.fail() || config.paquetes <= 0 || config.ttl < 0) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Entrada inválida.\n";
+        return;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    red.simularTrafico(config);
+}
+
+/**
+ * @brief Pide archivo, formato y contenido y exporta la matriz de costos
+ * o las tablas de enrutamiento sin pasar por la pantalla.
+ */
+void exportarRutas(Red& red) {
+    string archivo;
+    cout << "Archivo de salida: ";
+    getline(cin, archivo);
+    if (archivo.empty()) {
+        cout << "Entrada inválida.\n";
+        return;
+    }
+    int formato, contenido;
+    cout << "Formato (1 = CSV, 2 = binario): ";
+    cin >> formato;
+    cout << "Contenido (1 = matriz de costos, 2 = tablas de enrutamiento): ";
+    cin >> contenido;
+    if (cin.fail() || formato < 1 || formato > 2 || contenido < 1 || contenido > 2) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Entrada inválida.\n";
+        return;
+    }
+    cin.ignore(numeric_limits<streamsize>::max(), '\n');
+
+    red.exportarRutas(archivo,
+                      formato == 1 ? FormatoExportacion::CSV : FormatoExportacion::Binario,
+                      contenido == 1 ? ContenidoExportacion::Distancias : ContenidoExportacion::Tablas);
+}
+
+/**
+ * @brief Convierte una red entre el formato de texto y el binario.
+ * El sentido se decide por el contenido del archivo de entrada.
+ */
+int convertirFormato(const string& entrada, const string& salida) {
+    Red red;
+    if (esArchivoBinario(entrada))
+        return red.cargarBinario(entrada) && red.guardarEnArchivo(salida) ? 0 : 1;
+    return red.cargarDesdeArchivo(entrada) && red.guardarBinario(salida) ? 0 : 1;
+}
+
+/**
+ * @brief Escribe el volcado "clave valor" de la instrumentación en un archivo.
+ */
+bool volcarEstadisticas(const string& archivo) {
+    ofstream salida(archivo);
+    if (!salida.is_open()) {
+        cerr << "Error al abrir/crear archivo: " << archivo << endl;
+        return false;
+    }
+    volcarInstrumentacion(resumenInstrumentacion(), salida);
+    return true;
+}
+
+/**
+ * @brief Muestra los totales del proceso (contadores y tiempos por fase,
+ * con lo que crecieron los contadores durante cada fase) y permite
+ * volcarlos a un archivo y ponerlos en cero.
+ */
+void mostrarEstadisticas() {
+    mostrarInstrumentacion(resumenInstrumentacion(), cout);
+    if (!instrumentacionActiva()) return;
+
+    string archivo;
+    cout << "Archivo para el volcado (Enter = no guardar): ";
+    getline(cin, archivo);
+    if (!archivo.empty() && volcarEstadisticas(archivo))
+        cout << "Estadísticas guardadas en: " << archivo << endl;
+
+    string respuesta;
+    cout << "¿Reiniciar los contadores? (s/n): ";
+    getline(cin, respuesta);
+    if (respuesta == "s" || respuesta == "S") reiniciarInstrumentacion();
+}
+
+/**
+ * @brief Exporta la matriz de costos (o las tablas, con --tablas) de una
+ * topología en texto o binario. CSV si la salida termina en .csv.
+ */
+int exportarTopologia(const string& topologia, const string& salida, bool tablas, int hilos) {
+    Red red;
+    red.setHilos(hilos);
+    if (!red.cargarDesdeArchivo(topologia)) return 1;
+
+    bool csv = salida.size() >= 4 && salida.compare(salida.size() - 4, 4, ".csv") == 0;
+    bool ok = red.exportarRutas(salida, csv ? FormatoExportacion::CSV : FormatoExportacion::Binario,
+                                tablas ? ContenidoExportacion::Tablas : ContenidoExportacion::Distancias);
+    return ok ? 0 : 1;
+}
+
+/**
+ * @brief Modo por lotes: carga la topología, responde las consultas de
+ * 'consultas' (o de la entrada estándar si está vacío) y termina.
+ * Las respuestas van a 'salida' o a la salida estándar; el resumen, a cerr.
+ */
+int ejecutarLote(const string& topologia, const string& consultas, const string& salida, int hilos) {
+    Red red;
+    red.setHilos(hilos);
+
+    // Los mensajes de la carga van a cerr para no mezclarse con las respuestas
+    streambuf* anterior = cout.rdbuf(cerr.rdbuf());
+    if (!red.cargarDesdeArchivo(topologia)) {
+        cout.rdbuf(anterior);
+        return 1;
+    }
+    cout.rdbuf(anterior);
+
+    ios::sync_with_stdio(false);
+    ifstream archivoConsultas;
+    if (!consultas.empty()) {
+        archivoConsultas.open(consultas);
+        if (!archivoConsultas) {
+            cerr << "No se pudo abrir el archivo de consultas: " << consultas << endl;
+            return 1;
+        }
+    }
+    static char bufer[1 << 20];
+    ofstream archivoSalida;
+    if (!salida.empty()) {
+        archivoSalida.rdbuf()->pubsetbuf(bufer, sizeof bufer);
+        archivoSalida.open(salida);
+        if (!archivoSalida) {
+            cerr << "No se pudo crear el archivo de salida: " << salida << endl;
+            return 1;
+        }
+    }
+
+    EstadisticasLote est;
+    auto t0 = chrono::steady_clock::now();
+    procesarLote(red,
+                 consultas.empty() ? cin : archivoConsultas,
+                 salida.empty() ? cout : archivoSalida, &est);
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    cerr << est.consultas << " consultas, " << est.ediciones << " ediciones, "
+         << est.arboles << " árboles, " << est.errores << " errores en "
+         << segundos << " s";
+    if (segundos > 0) cerr << " (" << (long long)(est.consultas / segundos) << " consultas/s)";
+    cerr << endl;
+    return est.errores == 0 ? 0 : 2;
+}
+
+/**
+ * @brief Modo servidor: carga la topología y atiende consultas de rutas por
+ * un socket Unix (ver servidor.h y protocolo.h) hasta recibir SIGINT o SIGTERM.
+ */
+int servirTopologia(const string& topologia, const string& socket, int hilos) {
+    Red red;
+    streambuf* anterior = cout.rdbuf(cerr.rdbuf());
+    if (!red.cargarDesdeArchivo(topologia)) {
+        cout.rdbuf(anterior);
+        return 1;
+    }
+    cout.rdbuf(anterior);
+
+    ConfiguracionServidor configuracion;
+    configuracion.socket = socket;
+    configuracion.trabajadores = hilos;
+    return ejecutarServidor(red, configuracion);
+}
+
 int main(int argc, char *argv[]) {
+    // Argumentos opcionales:
+    //   --hilos N                     hilos para los cálculos de todos los pares
+    //   --convertir entrada salida    convierte texto <-> binario y termina
+    //   --lote topologia [consultas]  responde consultas sin menú (ver lote.h) y termina
+    //   --salida archivo              destino de las respuestas del modo por lotes
+    //   --semilla S                   semilla de las redes generadas (por defecto, el reloj)
+    //   --exportar topologia salida   exporta la matriz de costos (CSV si salida es .csv) y termina
+    //   --tablas                      con --exportar, exporta las tablas de enrutamiento
+    //   --estadisticas archivo        al terminar, vuelca la instrumentación en el archivo
+    //   --servidor topologia socket   atiende consultas por un socket Unix (--hilos = trabajadores)
+    int hilos = 0;
+    uint64_t semilla = 0;
+    string salidaLote, archivoEstadisticas;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (string(argv[i]) == "--hilos") hilos = atoi(argv[i + 1]);
+        if (string(argv[i]) == "--estadisticas") archivoEstadisticas = argv[i + 1];
+        if (string(argv[i]) == "--salida") salidaLote = argv[i + 1];
+        if (string(argv[i]) == "--semilla") semilla = strtoull(argv[i + 1], nullptr, 10);
+    }
+    // Al terminar (con o sin menú) se vuelca la instrumentación si se pidió
+    auto terminar = [&](int codigo) {
+        if (!archivoEstadisticas.empty() && !volcarEstadisticas(archivoEstadisticas) && codigo == 0) codigo = 1;
+        return codigo;
+    };
+    for (int i = 1; i + 2 < argc; ++i)
+        if (string(argv[i]) == "--convertir") return terminar(convertirFormato(argv[i + 1], argv[i + 2]));
+    bool exportarTablas = false;
+    for (int i = 1; i < argc; ++i)
+        if (string(argv[i]) == "--tablas") exportarTablas = true;
+    for (int i = 1; i + 2 < argc; ++i)
+        if (string(argv[i]) == "--exportar") return terminar(exportarTopologia(argv[i + 1], argv[i + 2], exportarTablas, hilos));
+    for (int i = 1; i + 2 < argc; ++i)
+        if (string(argv[i]) == "--servidor") return terminar(servirTopologia(argv[i + 1], argv[i + 2], hilos));
+    for (int i = 1; i + 1 < argc; ++i)
+        if (string(argv[i]) == "--lote") {
+            string consultas;
+            if (i + 2 < argc && string(argv[i + 2]).rfind("--", 0) != 0) consultas = argv[i + 2];
+            return terminar(ejecutarLote(argv[i + 1], consultas, salidaLote, hilos));
+        }
+
     Red* red = new Red();
-    string carpeta = "Datos";
+    red->setHilos(hilos);
+    CatalogoRedes catalogo;
+    catalogo.abrir("Datos");
     string nombreArchivo;
 
     // ======================================================
@@ -155,19 +541,15 @@ int main(int argc, char *argv[]) {
     cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
     if (opcion == 'c' || opcion == 'C') {
-        vector<string> disponibles = listarRedesDisponibles(carpeta);
-        if (!disponibles.empty()) {
-            cout << "Seleccione el número de red a cargar: ";
-            int eleccion;
-            cin >> eleccion;
-            cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
-            if (eleccion > 0 && eleccion <= (int)disponibles.size()) {
-                QDir dir(QString::fromStdString(carpeta));
-                QString rutaCompleta = dir.filePath(QString::fromStdString(disponibles[eleccion - 1]));
-                nombreArchivo = rutaCompleta.toStdString();
-                red->cargarDesdeArchivo(nombreArchivo);
-                cout << "Red " << eleccion << " cargada correctamente.\n";
+        if (listarRedesDisponibles(catalogo)) {
+            const RedCatalogada* elegida = elegirRed(catalogo, "Seleccione el número de red a cargar: ");
+            if (elegida) {
+                nombreArchivo = catalogo.ruta(*elegida);
+                if (!abrirRed(*red, catalogo, *elegida)) {
+                    cout << "No se pudo cargar la red. Finalizando.\n";
+                    delete red;
+                    return 0;
+                }
             } else {
                 cout << "Opción inválida. Finalizando.\n";
                 delete red;
@@ -180,14 +562,12 @@ int main(int argc, char *argv[]) {
     }
 
     if (opcion == 'n' || opcion == 'N') {
-        int cantidad;
-        cout << "Ingrese la cantidad de enrutadores para la nueva red: ";
-        cin >> cantidad;
-        cin.ignore(numeric_limits<streamsize>::max(), '\n');
-
         delete red;
-        red = new Red(cantidad);
-        red->generarRedAleatoria();
+        red = generarRedNueva(hilos, semilla);
+        if (!red) {
+            cout << "No se pudo generar la red. Finalizando.\n";
+            return 0;
+        }
 
         cout << "¿Desea guardar esta red? (s/n): ";
         char guardar;
@@ -195,10 +575,12 @@ int main(int argc, char *argv[]) {
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
         if (guardar == 's' || guardar == 'S') {
-            nombreArchivo = solicitarRutaGuardado(carpeta);
+            nombreArchivo = solicitarRutaGuardado(catalogo);
             if (!nombreArchivo.empty()) {
-                red->guardarEnArchivo(nombreArchivo);
-                cout << "Red guardada exitosamente en: " << nombreArchivo << endl;
+                if (guardarRed(*red, catalogo, nombreArchivo))
+                    cout << "Red guardada exitosamente en: " << nombreArchivo << endl;
+                else
+                    cout << "No se pudo guardar la red.\n";
             }
         }
     }
@@ -212,6 +594,7 @@ int main(int argc, char *argv[]) {
         cin >> opcionMenu;
         cin.ignore(numeric_limits<streamsize>::max(), '\n');
 
+        if (cin.fail() && cin.eof()) break;   // sin más entrada, como salir
         if (cin.fail()) {
             cin.clear();
             cin.ignore(numeric_limits<streamsize>::max(), '\n');
@@ -251,16 +634,37 @@ int main(int argc, char *argv[]) {
             red->eliminarEnlace();
             break;
         case 7: {
-            string rutaGuardado = solicitarRutaGuardado(carpeta);
+            string rutaGuardado = solicitarRutaGuardado(catalogo);
             if (!rutaGuardado.empty()) {
-                red->guardarEnArchivo(rutaGuardado);
-                nombreArchivo = rutaGuardado;
-                cout << "Red guardada exitosamente.\n";
+                if (guardarRed(*red, catalogo, rutaGuardado)) {
+                    nombreArchivo = rutaGuardado;
+                    cout << "Red guardada exitosamente.\n";
+                } else {
+                    cout << "No se pudo guardar la red.\n";
+                }
             }
             break;
         }
         case 8:
-            red->mostrarTablasDeEnrutamiento();
+            red->mostrarTablasDeEnrutamiento(leerIds("IDs de los enrutadores a mostrar (Enter = todos): "));
+            break;
+        case 10:
+            simularVectorDistancia(*red);
+            break;
+        case 11:
+            simularEstadoEnlace(*red);
+            break;
+        case 12:
+            simularTrafico(*red, semilla);
+            break;
+        case 13:
+            exportarRutas(*red);
+            break;
+        case 14:
+            mostrarEstadisticas();
+            break;
+        case 15:
+            red->prepararJerarquia();
             break;
         case 9:
             cout << "\nSaliendo del programa...\n";
@@ -272,5 +676,5 @@ int main(int argc, char *argv[]) {
 
     delete red;
     cout << "Programa finalizado correctamente.\n";
-    return 0;
+    return terminar(0);
 }
@@ -0,0 +1,102 @@
+#include "matrizcostos.h"
+#include <algorithm>
+using namespace std;
+
+// ============================
+// Dimensiones y ancho
+// ============================
+int MatrizCostos::anchoPara(int costoMinimo, int costoMaximo) {
+    if (costoMinimo < 0) return 0;
+    if (costoMaximo < UINT8_MAX) return 1;
+    if (costoMaximo < UINT16_MAX) return 2;
+    return 0;
+}
+
+void MatrizCostos::dimensionar(int lado, int ancho) {
+    l = paso = lado;
+    c8.clear();
+    c16.clear();
+    if (ancho == 1) c8.assign((size_t)lado * lado, sinEnlace<uint8_t>());
+    else c16.assign((size_t)lado * lado, sinEnlace<uint16_t>());
+}
+
+template <typename T>
+void MatrizCostos::copiarA(vector<T>& destino, int nuevoPaso) const {
+    destino.assign((size_t)nuevoPaso * nuevoPaso, sinEnlace<T>());
+    for (int a = 0; a < l; ++a)
+        paraCadaVecino(a, [&](int b, int c) { destino[(size_t)a * nuevoPaso + b] = (T)c; });
+}
+
+// Con lugar de sobra solo se corre el lado; si no, se copia a una matriz
+// un 50 % más grande para que agregar ranuras de a una no sea cuadrático
+void MatrizCostos::crecer(int lado) {
+    if (lado <= paso) {
+        l = max(l, lado);
+        return;
+    }
+    int nuevoPaso = max(lado, paso + paso / 2);
+    if (c16.empty()) {
+        vector<uint8_t> nueva;
+        copiarA(nueva, nuevoPaso);
+        c8 = move(nueva);
+    } else {
+        vector<uint16_t> nueva;
+        copiarA(nueva, nuevoPaso);
+        c16 = move(nueva);
+    }
+    paso = nuevoPaso;
+    l = lado;
+}
+
+void MatrizCostos::ensanchar() {
+    if (!c16.empty()) return;
+    c16.resize(c8.size());
+    for (size_t k = 0; k < c8.size(); ++k)
+        c16[k] = c8[k] == sinEnlace<uint8_t>() ? sinEnlace<uint16_t>() : c8[k];
+    vector<uint8_t>().swap(c8);
+}
+
+void MatrizCostos::liberar() {
+    l = paso = 0;
+    vector<uint8_t>().swap(c8);
+    vector<uint16_t>().swap(c16);
+}
+
+// ============================
+// Enlaces
+// ============================
+bool MatrizCostos::cabe(int costo) const {
+    int ancho = anchoPara(costo, costo);
+    return ancho != 0 && ancho <= this->ancho();
+}
+
+int MatrizCostos::costo(int a, int b) const {
+    size_t k = (size_t)a * paso + b;
+    if (c16.empty()) return c8[k] == sinEnlace<uint8_t>() ? QUITAR_VECINO : c8[k];
+    return c16[k] == sinEnlace<uint16_t>() ? QUITAR_VECINO : c16[k];
+}
+
+void MatrizCostos::asignar(int a, int b, int costo) {
+    size_t k = (size_t)a * paso + b;
+    if (c16.empty()) c8[k] = (uint8_t)costo;
+    else c16[k] = (uint16_t)costo;
+}
+
+void MatrizCostos::quitar(int a, int b) {
+    size_t k = (size_t)a * paso + b;
+    if (c16.empty()) c8[k] = sinEnlace<uint8_t>();
+    else c16[k] = sinEnlace<uint16_t>();
+}
+
+void MatrizCostos::limpiar(int ranura) {
+    for (int b = 0; b < l; ++b) {
+        quitar(ranura, b);
+        quitar(b, ranura);
+    }
+}
+
+int MatrizCostos::grado(int a) const {
+    int g = 0;
+    paraCadaVecino(a, [&](int, int) { ++g; });
+    return g;
+}
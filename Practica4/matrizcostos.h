@@ -0,0 +1,70 @@
+#ifndef MATRIZCOSTOS_H
+#define MATRIZCOSTOS_H
+
+#include "enrutador.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+// ===========================
+// Matriz de costos empaquetada
+// ===========================
+// Adyacencia densa para redes casi completas: una matriz por ranura de la
+// Red con el costo de cada par en 1 o 2 bytes y el máximo del tipo como
+// "sin enlace". Una lista de vecinos gasta 8 bytes por enlace dirigido, así
+// que con densidad alta la matriz ocupa varias veces menos.
+//
+// Se guarda entera (las dos mitades) para que los vecinos de una ranura
+// sean una fila contigua. Las filas tienen 'paso' celdas, con lugar para
+// agregar ranuras sin mover toda la matriz cada vez.
+//
+// Red la usa en lugar de Router::vecinos cuando conviene (ver
+// Red::ajustarAlmacenamiento); las instantáneas CSR se arman igual desde
+// cualquiera de las dos disposiciones.
+class MatrizCostos {
+public:
+    // Ancho en bytes con el que entran costos en [minimo, maximo] (0 = no entran)
+    static int anchoPara(int costoMinimo, int costoMaximo);
+
+    void dimensionar(int lado, int ancho);   // todo sin enlaces
+    void crecer(int lado);                   // conserva los costos; las ranuras nuevas, sin enlaces
+    void ensanchar();                        // de 1 a 2 bytes por costo
+    void liberar();
+
+    int lado() const { return l; }
+    int ancho() const { return c16.empty() ? 1 : 2; }
+    size_t bytes() const { return c8.capacity() + 2 * c16.capacity(); }
+    bool cabe(int costo) const;              // entra en el ancho actual
+
+    int costo(int a, int b) const;           // QUITAR_VECINO si no hay enlace
+    void asignar(int a, int b, int costo);   // en un sentido; debe caber
+    void quitar(int a, int b);
+    void limpiar(int ranura);                // fila y columna sin enlaces
+
+    // f(vecino, costo) para cada enlace de la ranura, en orden de ranura
+    template <typename F> void paraCadaVecino(int a, F&& f) const {
+        if (c16.empty()) recorrer(c8.data() + (size_t)a * paso, f);
+        else recorrer(c16.data() + (size_t)a * paso, f);
+    }
+    int grado(int a) const;
+
+private:
+    template <typename T, typename F> void recorrer(const T* fila, F& f) const {
+        for (int b = 0; b < l; ++b)
+            if (fila[b] != sinEnlace<T>()) f(b, (int)fila[b]);
+    }
+    template <typename T> static constexpr T sinEnlace() { return (T)-1; }
+    template <typename T> void copiarA(std::vector<T>& destino, int nuevoPaso) const;
+
+    int l = 0;
+    int paso = 0;
+    std::vector<uint8_t> c8;     // c8[a*paso + b]; vacío si el ancho es 2
+    std::vector<uint16_t> c16;   // c16[a*paso + b]; vacío si el ancho es 1
+};
+
+// Ranuras mínimas para considerar la matriz; en redes más chicas la
+// diferencia de memoria no importa
+const int LADO_MINIMO_MATRIZ = 64;
+
+#endif // MATRIZCOSTOS_H
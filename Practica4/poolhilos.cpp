@@ -0,0 +1,106 @@
+#include "poolhilos.h"
+#include <algorithm>
+using namespace std;
+
+// ============================
+// Constructor y destructor
+// ============================
+PoolHilos::PoolHilos(int cantidad) {
+    if (cantidad <= 0) cantidad = (int)thread::hardware_concurrency();
+    total = max(1, cantidad);
+
+    for (int i = 0; i < total; ++i)
+        colas.push_back(make_unique<Cola>());
+
+    // Con un solo hilo el trabajo se ejecuta en el hilo que llama
+    if (total > 1) {
+        for (int i = 0; i < total; ++i)
+            hilos.emplace_back(&PoolHilos::trabajar, this, i);
+    }
+}
+
+PoolHilos::~PoolHilos() {
+    {
+        lock_guard<mutex> lock(m);
+        terminar = true;
+    }
+    cvInicio.notify_all();
+    for (auto& h : hilos) h.join();
+}
+
+// ============================
+// Reparto y ejecución
+// ============================
+void PoolHilos::paraCada(int cantidad, const function<void(int, int)>& tarea, int bloque) {
+    if (cantidad <= 0) return;
+    bloque = max(1, bloque);
+
+    if (hilos.empty()) {
+        for (int i = 0; i < cantidad; ++i) tarea(i, 0);
+        return;
+    }
+
+    lock_guard<mutex> ejecucion(mEjecucion);
+
+    // Repartir bloques consecutivos: el hilo h recibe su tramo contiguo de índices
+    int bloques = (cantidad + bloque - 1) / bloque;
+    for (int b = 0; b < bloques; ++b) {
+        int h = (int)((long long)b * total / bloques);
+        int ini = b * bloque;
+        lock_guard<mutex> lockCola(colas[h]->m);
+        colas[h]->rangos.push_back({ini, min(cantidad, ini + bloque)});
+    }
+
+    unique_lock<mutex> lock(m);
+    tareaActual = &tarea;
+    pendientes = total;
+    ++generacion;
+    cvInicio.notify_all();
+    cvFin.wait(lock, [this]{ return pendientes == 0; });
+    tareaActual = nullptr;
+}
+
+bool PoolHilos::tomarTrabajo(int hilo, pair<int,int>& rango) {
+    {
+        Cola& propia = *colas[hilo];
+        lock_guard<mutex> lock(propia.m);
+        if (!propia.rangos.empty()) {
+            rango = propia.rangos.front();
+            propia.rangos.pop_front();
+            return true;
+        }
+    }
+    // Robar del final de las colas ajenas
+    for (int k = 1; k < total; ++k) {
+        Cola& otra = *colas[(hilo + k) % total];
+        lock_guard<mutex> lock(otra.m);
+        if (!otra.rangos.empty()) {
+            rango = otra.rangos.back();
+            otra.rangos.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
+
+void PoolHilos::trabajar(int hilo) {
+    unsigned vista = 0;
+    while (true) {
+        const function<void(int, int)>* tarea;
+        {
+            unique_lock<mutex> lock(m);
+            cvInicio.wait(lock, [&]{ return terminar || generacion != vista; });
+            if (terminar) return;
+            vista = generacion;
+            tarea = tareaActual;
+        }
+
+        pair<int,int> rango;
+        while (tomarTrabajo(hilo, rango))
+            for (int i = rango.first; i < rango.second; ++i)
+                (*tarea)(i, hilo);
+
+        lock_guard<mutex> lock(m);
+        if (--pendientes == 0) cvFin.notify_one();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef POOLHILOS_H
+#define POOLHILOS_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+
+// ===========================
+// Pool de hilos con robo de trabajo
+// ===========================
+// Los índices de cada trabajo se reparten en bloques entre las colas de los
+// hilos; cada hilo consume su cola por el frente y, cuando se vacía, roba
+// bloques del final de la cola de otro hilo.
+class PoolHilos {
+public:
+    explicit PoolHilos(int cantidad = 0);   // 0 = núcleos disponibles
+    ~PoolHilos();
+
+    PoolHilos(const PoolHilos&) = delete;
+    PoolHilos& operator=(const PoolHilos&) = delete;
+
+    int cantidadHilos() const { return total; }
+
+    // Ejecuta tarea(i, hilo) para todo i en [0, cantidad) y espera a que terminen.
+    // 'hilo' está en [0, cantidadHilos()) y sirve para indexar memoria propia de cada hilo.
+    void paraCada(int cantidad, const std::function<void(int, int)>& tarea, int bloque = 1);
+
+private:
+    struct Cola {
+        std::mutex m;
+        std::deque<std::pair<int,int>> rangos; // [inicio, fin)
+    };
+
+    void trabajar(int hilo);
+    bool tomarTrabajo(int hilo, std::pair<int,int>& rango);
+
+    int total;
+    std::vector<std::thread> hilos;
+    std::vector<std::unique_ptr<Cola>> colas;
+
+    std::mutex mEjecucion;   // serializa llamadas concurrentes a paraCada
+    std::mutex m;
+    std::condition_variable cvInicio;
+    std::condition_variable cvFin;
+    const std::function<void(int, int)>* tareaActual = nullptr;
+    unsigned generacion = 0;
+    int pendientes = 0;
+    bool terminar = false;
+};
+
+#endif // POOLHILOS_H
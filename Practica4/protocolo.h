@@ -0,0 +1,59 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+#include <cstdint>
+
+// ===========================
+// Protocolo del servidor de rutas
+// ===========================
+// Mensajes binarios de tamaño fijo por un socket Unix local, en el orden de
+// bytes de la máquina (cliente y servidor corren en el mismo equipo).
+//
+// Cada solicitud ocupa 16 bytes. Cada respuesta es una cabecera de 16
+// bytes seguida de 'cantidad' enteros de 32 bits:
+//
+//   INFO    {nodos, número de versión, id más alto}; los ids pueden
+//           tener huecos, así que no todo id hasta el más alto existe
+//   COSTO   nada; el costo va en la cabecera
+//   RUTA    ids del camino, origen y destino incluidos
+//   TABLA   ternas {destino, costo, siguiente salto} de los destinos
+//           alcanzables desde el origen, sin el propio origen
+//
+// Un cliente puede mandar varias solicitudes sin esperar (tubería): las
+// respuestas de una conexión llegan en el mismo orden y repiten el 'id'
+// de su solicitud. Después de cerrar su mitad de escritura (shutdown) el
+// cliente sigue recibiendo las respuestas de lo que ya mandó.
+enum TipoSolicitud : uint16_t {
+    SOLICITUD_INFO = 0,
+    SOLICITUD_COSTO = 1,
+    SOLICITUD_RUTA = 2,
+    SOLICITUD_TABLA = 3
+};
+
+enum EstadoRespuesta : uint16_t {
+    RESPUESTA_OK = 0,
+    RESPUESTA_SIN_RUTA = 1,       // costo = -1
+    RESPUESTA_ID_INVALIDO = 2,
+    RESPUESTA_TIPO_INVALIDO = 3
+};
+
+struct SolicitudRuta {
+    uint32_t id;          // lo elige el cliente
+    uint16_t tipo;        // TipoSolicitud
+    uint16_t reservado;
+    int32_t origen;       // id del enrutador (R<id>)
+    int32_t destino;
+};
+
+struct RespuestaRuta {
+    uint32_t id;
+    uint16_t estado;      // EstadoRespuesta
+    uint16_t tipo;
+    int32_t costo;
+    uint32_t cantidad;    // enteros que siguen a la cabecera
+};
+
+static_assert(sizeof(SolicitudRuta) == 16, "la solicitud debe ocupar 16 bytes");
+static_assert(sizeof(RespuestaRuta) == 16, "la cabecera de la respuesta debe ocupar 16 bytes");
+
+#endif // PROTOCOLO_H
@@ -1,6 +1,18 @@
 // red.cpp (reemplaza tu archivo actual)
 #include "red.h"
 #include "enrutador.h"
+#include "grafocsr.h"
+#include "bidireccional.h"
+#include "formatobinario.h"
+#include "cargadortexto.h"
+#include "todospares.h"
+#include "poolhilos.h"
+#include "vectordistancia.h"
+#include "estadoenlace.h"
+#include "reenvio.h"
+#include "exportacion.h"
+#include "jerarquia.h"
+#include "instrumentacion.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -14,6 +26,12 @@
 #include <ctime>
 #include <climits>
 #include <map>
+#include <unordered_set>
+#include <numeric>
+#include <charconv>
+#include <string_view>
+#include <chrono>
+#include <cstdio>
 using namespace std;
 
 // ============================
@@ -22,105 +40,330 @@ using namespace std;
 Red::Red() {}
 
 Red::Red(int cantidad) {
-    for (int i = 1; i <= cantidad; ++i)
-        enrutadores.push_back(new Router(i));
+    enrutadores.reserve(max(0, cantidad));
+    ranuraDeId.reserve(max(0, cantidad));
+    for (int i = 1; i <= cantidad; ++i) {
+        enrutadores.emplace_back(i, &arena);
+        ranuraDeId.emplace(i, i - 1);
+    }
+    siguienteId = max(0, cantidad) + 1;
 }
 
-Red::~Red() {
-    for (auto* r : enrutadores)
-        delete r;
+// Los enrutadores no tienen destructor propio: sus listas de vecinos se
+// liberan todas juntas con la arena
+Red::~Red() {}
+
+// Descarta la red actual entera, en bloque
+void Red::vaciar() {
     enrutadores.clear();
+    ranurasLibres.clear();
+    ranuraDeId.clear();
+    siguienteId = 1;
+    matriz.liberar();
+    densa = false;
+    enlacesDirigidos = 0;
+    costoMinimoEnlaces = INT_MAX;
+    costoMaximoEnlaces = INT_MIN;
+    arena.release();
+    versionVieja = true;
+    rutas.invalidar();
+    vectorDistancia.reset();
+    estadoEnlace.reset();
+    jerarquia.reset();
+}
+
+// ============================
+// Ranuras e ids
+// ============================
+// Cada enrutador ocupa una ranura de 'enrutadores' y las listas de vecinos
+// guardan ranuras, así que eliminar uno solo toca a sus vecinos: su ranura
+// queda libre (id 0) para el próximo que se cree y los demás conservan
+// ranura e id. La instantánea CSR se arma con las ranuras ocupadas en orden
+// de id, de modo que sus índices siguen siendo densos.
+int Red::ranuraDe(int id) const {
+    auto it = ranuraDeId.find(id);
+    return it == ranuraDeId.end() ? -1 : it->second;
+}
+
+ReferenciaEnrutador Red::referencia(int id) const {
+    int ranura = ranuraDe(id);
+    if (ranura < 0) return {};
+    return {ranura, enrutadores[ranura].generacion};
+}
+
+int Red::idDe(ReferenciaEnrutador referencia) const {
+    if (referencia.ranura < 0 || referencia.ranura >= (int)enrutadores.size()) return 0;
+    const Router& r = enrutadores[referencia.ranura];
+    return r.generacion == referencia.generacion ? r.id : 0;
+}
+
+int Red::ocuparRanura(int id) {
+    int ranura;
+    if (ranurasLibres.empty()) {
+        ranura = enrutadores.size();
+        enrutadores.emplace_back(id, &arena);
+        if (densa) matriz.crecer(ranura + 1);
+    } else {
+        ranura = ranurasLibres.back();
+        ranurasLibres.pop_back();
+        enrutadores[ranura].id = id;
+    }
+    ranuraDeId.emplace(id, ranura);
+    return ranura;
+}
+
+void Red::liberarRanura(int ranura) {
+    Router& r = enrutadores[ranura];
+    if (densa) {
+        enlacesDirigidos -= 2 * matriz.grado(ranura);
+        matriz.limpiar(ranura);
+    } else {
+        for (const Vecino& v : r.vecinos)
+            enrutadores[v.indice].eliminarVecino(ranura);
+        enlacesDirigidos -= 2 * r.vecinos.size();
+        r.vecinos.liberar(&arena);
+    }
+    ranuraDeId.erase(r.id);
+    r.id = 0;
+    ++r.generacion;
+    ranurasLibres.push_back(ranura);
+}
+
+// ============================
+// Disposición de la adyacencia
+// ============================
+// Con pocos enlaces cada enrutador guarda su lista de vecinos (8 bytes por
+// enlace dirigido); en redes casi completas conviene la matriz de costos
+// empaquetada (1 o 2 bytes por par de ranuras). Todo lo que lee o cambia
+// enlaces pasa por estas funciones, así que el resto de la Red no depende
+// de la disposición, y las instantáneas CSR se arman desde cualquiera.
+int Red::costoEntre(int ranura1, int ranura2) const {
+    if (densa) {
+        int costo = matriz.costo(ranura1, ranura2);
+        return costo == QUITAR_VECINO ? INFINITO : costo;
+    }
+    const Vecino* v = enrutadores[ranura1].vecinos.buscar(ranura2);
+    return v ? v->costo : INFINITO;
+}
+
+void Red::fijarEnlace(int ranura1, int ranura2, int costo) {
+    if (densa && !matriz.cabe(costo)) {
+        if (MatrizCostos::anchoPara(costo, costo) == 2) matriz.ensanchar();
+        else pasarADispersa(); // costo negativo o de más de 16 bits
+    }
+    costoMinimoEnlaces = min(costoMinimoEnlaces, costo);
+    costoMaximoEnlaces = max(costoMaximoEnlaces, costo);
+    if (costoEntre(ranura1, ranura2) == INFINITO) enlacesDirigidos += 2;
+    if (densa) {
+        matriz.asignar(ranura1, ranura2, costo);
+        matriz.asignar(ranura2, ranura1, costo);
+    } else {
+        enrutadores[ranura1].nuevoVecino(ranura2, costo);
+        enrutadores[ranura2].nuevoVecino(ranura1, costo);
+    }
+}
+
+void Red::quitarEnlace(int ranura1, int ranura2) {
+    if (costoEntre(ranura1, ranura2) == INFINITO) return;
+    enlacesDirigidos -= 2;
+    if (densa) {
+        matriz.quitar(ranura1, ranura2);
+        matriz.quitar(ranura2, ranura1);
+    } else {
+        enrutadores[ranura1].eliminarVecino(ranura2);
+        enrutadores[ranura2].eliminarVecino(ranura1);
+    }
+}
+
+void Red::vecinosDe(int ranura, vector<Vecino>& vecinos) const {
+    vecinos.clear();
+    if (densa) matriz.paraCadaVecino(ranura, [&](int v, int costo) { vecinos.push_back({v, costo}); });
+    else vecinos.assign(enrutadores[ranura].vecinos.begin(), enrutadores[ranura].vecinos.end());
+}
+
+// Se pasa a la matriz cuando ocuparía menos de la mitad que las listas, y
+// se vuelve a las listas cuando ellas ocuparían menos de la mitad que la
+// matriz. Entre ambos umbrales se queda la disposición actual, así que una
+// red que oscila cerca del límite no se convierte en cada edición
+void Red::ajustarAlmacenamiento() {
+    size_t bytesListas = enlacesDirigidos * sizeof(Vecino);
+    if (densa) {
+        if (2 * bytesListas < matriz.bytes()) pasarADispersa();
+        return;
+    }
+    size_t lado = enrutadores.size();
+    int ancho = MatrizCostos::anchoPara(costoMinimoEnlaces, costoMaximoEnlaces);
+    if (ancho == 0 || (int)lado < LADO_MINIMO_MATRIZ) return;
+    if (bytesListas > 2 * lado * lado * ancho) pasarADensa(ancho);
+}
+
+void Red::pasarADensa(int ancho) {
+    matriz.dimensionar(enrutadores.size(), ancho);
+    for (int r = 0; r < (int)enrutadores.size(); ++r) {
+        for (auto& [v, costo] : enrutadores[r].vecinos) matriz.asignar(r, v, costo);
+        enrutadores[r].vecinos.liberar(&arena);
+    }
+    arena.release(); // la memoria de las listas vuelve al sistema
+    densa = true;
+}
+
+void Red::pasarADispersa() {
+    // Las cotas de los costos se recalculan exactas (las ediciones solo las ensanchan)
+    costoMinimoEnlaces = INT_MAX;
+    costoMaximoEnlaces = INT_MIN;
+    densa = false;
+    for (int r = 0; r < matriz.lado(); ++r) {
+        if (enrutadores[r].id == 0) continue;
+        Router& router = enrutadores[r];
+        router.vecinos.reservar(matriz.grado(r), &arena);
+        matriz.paraCadaVecino(r, [&](int v, int costo) {
+            router.nuevoVecino(v, costo); // en orden de ranura: se agrega al final
+            costoMinimoEnlaces = min(costoMinimoEnlaces, costo);
+            costoMaximoEnlaces = max(costoMaximoEnlaces, costo);
+        });
+    }
+    matriz.liberar();
+}
+
+// ============================
+// Hilos de cómputo
+// ============================
+void Red::setHilos(int cantidad) {
+    hilos = cantidad;
+    pool.reset(); // se recrea con el nuevo tamaño en el próximo uso
+}
+
+// ============================
+// Versiones de la topología
+// ============================
+// Las ediciones cambian 'enrutadores' con mEdicion tomado y marcan la
+// versión publicada como vieja; la instantánea nueva se arma recién cuando
+// alguien la pide (el hilo que edita o un lector), así una serie de
+// ediciones seguidas no rehace la CSR en cada una. Los lectores solo
+// esperan el mutex si hay que publicar, nunca durante una consulta.
+VersionFijada Red::fijarVersion() const {
+    if (versionVieja.load(memory_order_acquire)) {
+        lock_guard<mutex> candado(mEdicion);
+        if (versionVieja.load(memory_order_relaxed)) {
+            MEDIR_FASE(FASE_INSTANTANEA);
+            versiones.publicar(construirGrafoCSR(enrutadores, densa ? &matriz : nullptr));
+            versionVieja.store(false, memory_order_release);
+        }
+    }
+    return versiones.fijar();
+}
+
+const GrafoCSR& Red::instantanea() const {
+    if (versionVieja.load(memory_order_acquire) || numeroGrafo != versiones.numero()) {
+        VersionFijada v = fijarVersion();
+        grafoCSR = v->grafo; // comparte los arreglos con la versión
+        numeroGrafo = v->numero;
+    }
+    return grafoCSR;
+}
+
+PoolHilos& Red::obtenerPool() const {
+    if (!pool) pool = make_unique<PoolHilos>(hilos);
+    return *pool;
 }
 
 // ============================
 // Generación y visualización
 // ============================
-void Red::generarRedAleatoria() {
-    srand((unsigned)time(nullptr));
-    int n = enrutadores.size();
+void Red::generarRedAleatoria(uint64_t semilla) {
+    if (semilla == 0) semilla = (uint64_t)time(nullptr);
+    int n = ranuraDeId.size();
 
     if (n <= 0) {
         cout << "No hay enrutadores para generar la red.\n";
         return;
     }
 
-    // Conectar TODOS los pares con un costo aleatorio (1..20)
+    lock_guard<mutex> candado(mEdicion);
+
+    // Van a quedar todos los pares conectados: la disposición se elige
+    // antes de llenarla, así una red completa nunca pasa por las listas
+    ModeloCosto costos;
+    enlacesDirigidos = (size_t)n * (n - 1);
+    costoMinimoEnlaces = min(costoMinimoEnlaces, costos.minimo);
+    costoMaximoEnlaces = max(costoMaximoEnlaces, costos.maximo);
+    ajustarAlmacenamiento();
+
+    // Con listas, cada una se reserva completa de una vez
+    vector<int> ranuras;
+    ranuras.reserve(n);
+    for (int r = 0; r < (int)enrutadores.size(); ++r) {
+        if (enrutadores[r].id == 0) continue;
+        if (!densa) enrutadores[r].vecinos.reservar(n - 1, &arena);
+        ranuras.push_back(r);
+    }
+
+    // Conectar TODOS los pares con un costo aleatorio (1..20) que depende
+    // solo de la semilla y del par
     for (int i = 0; i < n; ++i) {
         for (int j = i + 1; j < n; ++j) {
-            int costo = (rand() % 20) + 1; // costo entre 1 y 20
-            enrutadores[i]->nuevoVecino(enrutadores[j], costo);
-            enrutadores[j]->nuevoVecino(enrutadores[i], costo);
+            int costo = costoEnlace(costos, semilla, i, j);
+            if (densa) {
+                matriz.asignar(ranuras[i], ranuras[j], costo);
+                matriz.asignar(ranuras[j], ranuras[i], costo);
+            } else {
+                enrutadores[ranuras[i]].nuevoVecino(ranuras[j], costo);
+                enrutadores[ranuras[j]].nuevoVecino(ranuras[i], costo);
+            }
         }
     }
 
+    versionVieja = true;
+    rutas.invalidar();
+    vectorDistancia.reset();
+    estadoEnlace.reset();
     cout << "Red aleatoria (completamente conectada) generada correctamente.\n";
+    if (densa)
+        cout << "Enlaces guardados en una matriz de costos de " << (matriz.bytes() >> 10) << " KiB.\n";
+}
+
+bool Red::generarTopologia(const ParametrosTopologia& parametros) {
+    GrafoCSR nuevo;
+    if (!::generarTopologia(parametros, obtenerPool(), nuevo)) return false;
+    reemplazarDesdeCSR(move(nuevo));
+    cout << "Red generada: " << ranuraDeId.size() << " enrutadores, "
+         << grafoCSR.destino.size() / 2 << " enlaces.\n";
+    return true;
 }
 
 void Red::mostrarRed() const {
-    int n = enrutadores.size();
-    if (n == 0) {
+    MEDIR_FASE(FASE_MOSTRAR_RED);
+    if (ranuraDeId.empty()) {
         cout << "No hay enrutadores en la red.\n";
         return;
     }
 
-    // Matriz de distancias mínimas
-    vector<vector<int>> distancias(n, vector<int>(n, INT_MAX));
-
-    // Aplicar Dijkstra para cada enrutador como origen
-    for (int i = 0; i < n; ++i) {
-        string origen = enrutadores[i]->getNombre();
-
-        map<string,int> dist;
-        priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-        for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-
-        dist[origen] = 0;
-        pq.push({0, origen});
-
-        while (!pq.empty()) {
-            auto [d, actual] = pq.top(); pq.pop();
-            if (d > dist[actual]) continue;
-
-            Router* r_actual = nullptr;
-            for (auto* r : enrutadores)
-                if (r->getNombre() == actual) { r_actual = r; break; }
-            if (!r_actual) continue;
-
-            for (auto& p : r_actual->vecinos) {
-                Router* vecino = p.first;
-                int costo = p.second;
-                string nombreVec = vecino->getNombre();
-                if (dist[actual] + costo < dist[nombreVec]) {
-                    dist[nombreVec] = dist[actual] + costo;
-                    pq.push({dist[nombreVec], nombreVec});
-                }
-            }
-        }
-
-        // Guardar resultados en la matriz
-        for (int j = 0; j < n; ++j) {
-            string destino = enrutadores[j]->getNombre();
-            if (dist[destino] != INT_MAX)
-                distancias[i][j] = dist[destino];
-        }
-    }
+    // Matriz de distancias mínimas: se reutilizan las tablas en caché si
+    // están al día; si no, Dijkstra por origen en paralelo o Floyd–Warshall
+    const GrafoCSR& grafo = rutas.valida() ? rutas.grafo() : instantanea();
+    int n = grafo.cantidadNodos();
+    MatrizTodosLosPares calculada;
+    if (!rutas.valida())
+        calcularTodosLosPares(grafo, obtenerPool(), calculada, false);
+    const MatrizTodosLosPares& distancias = rutas.valida() ? rutas.tablas() : calculada;
 
     // Mostrar la matriz
     cout << "\n========= MATRIZ DE COSTOS (RUTAS MÁS CORTAS - DIJKSTRA) =========\n";
     cout << setw(5) << " ";
     for (int j = 0; j < n; ++j)
-        cout << setw(6) << "R" + to_string(j + 1);
+        cout << setw(6) << grafo.nombre(j);
     cout << endl;
 
     for (int i = 0; i < n; ++i) {
-        cout << setw(4) << "R" + to_string(i + 1);
+        cout << setw(4) << grafo.nombre(i);
+        const int* fila = distancias.filaDist(i);
         for (int j = 0; j < n; ++j) {
             if (i == j)
                 cout << setw(6) << "0";
-            else if (distancias[i][j] == INT_MAX)
+            else if (fila[j] == INFINITO)
                 cout << setw(6) << "-";
             else
-                cout << setw(6) << distancias[i][j];
+                cout << setw(6) << fila[j];
         }
         cout << endl;
     }
@@ -133,24 +376,31 @@ void Red::mostrarRed() const {
 
 // guardarEnArchivo ahora SOLO guarda la red en el archivo que se le pasa
 // en formato de enlaces: "R1 R2 5" por línea (sin duplicados, orden numérico).
-void Red::guardarEnArchivo(const string& rutaArchivo) const {
-    ofstream archivo(rutaArchivo);
+// Se escribe en <archivo>.tmp y se renombra encima, así un error a mitad de
+// camino no pisa la versión anterior.
+bool Red::guardarEnArchivo(const string& rutaArchivo) const {
+    MEDIR_FASE(FASE_GUARDADO);
+    string temporal = rutaArchivo + ".tmp";
+    ofstream archivo(temporal);
     if (!archivo.is_open()) {
-        cerr << "Error al abrir/crear archivo: " << rutaArchivo << endl;
-        return;
+        cerr << "Error al abrir/crear archivo: " << temporal << endl;
+        return false;
     }
 
-    // Guardamos únicamente enlaces únicos (r->id < vecino->id) en orden numérico
+    // Guardamos únicamente enlaces únicos (r.id < vecino.id) en orden numérico
     // para que el archivo sea fácil de cargar.
     // Formato por línea: R<idOrigen> R<idDestino> <costo>
     // Ordenamos por id para salida consistente.
     vector<tuple<int,int,int>> enlaces;
-    for (auto* r : enrutadores) {
-        for (auto& p : r->vecinos) {
-            Router* vec = p.first;
-            int costo = p.second;
-            if (r->id < vec->id) {
-                enlaces.emplace_back(r->id, vec->id, costo);
+    vector<Vecino> vecinos;
+    for (int ranura = 0; ranura < (int)enrutadores.size(); ++ranura) {
+        const Router& r = enrutadores[ranura];
+        if (r.id == 0) continue;
+        vecinosDe(ranura, vecinos);
+        for (auto& [v, costo] : vecinos) {
+            const Router& vec = enrutadores[v];
+            if (r.id < vec.id) {
+                enlaces.emplace_back(r.id, vec.id, costo);
             }
         }
     }
@@ -164,115 +414,249 @@ void Red::guardarEnArchivo(const string& rutaArchivo) const {
         archivo << "R" << get<0>(t) << " R" << get<1>(t) << " " << get<2>(t) << "\n";
     }
     archivo.close();
-
-    // Además, registramos el nombre en lista_rutas.txt (evita duplicados)
-    string lista = "lista_rutas.txt";
-    // Leemos si ya existe para evitar duplicados
-    bool ya = false;
-    ifstream in(lista);
-    if (in.is_open()) {
-        string line;
-        while (getline(in, line)) {
-            if (line == rutaArchivo) { ya = true; break; }
-        }
-        in.close();
+    if (!archivo) {
+        cerr << "Error al escribir: " << temporal << endl;
+        remove(temporal.c_str());
+        return false;
     }
-    if (!ya) {
-        ofstream out(lista, ios::app);
-        if (out.is_open()) {
-            out << rutaArchivo << "\n";
-            out.close();
-        }
+    if (rename(temporal.c_str(), rutaArchivo.c_str()) != 0) {
+        cerr << "Error al reemplazar: " << rutaArchivo << endl;
+        remove(temporal.c_str());
+        return false;
     }
 
     cout << "Red guardada en: " << rutaArchivo << endl;
+    guardarJerarquia(rutaArchivo);
+    return true;
 }
 
 // Cargar espera líneas con formato: R<num> R<num> <costo>
-void Red::cargarDesdeArchivo(const string& nombreArchivo) {
-    ifstream archivo(nombreArchivo);
-    if (!archivo.is_open()) {
-        cerr << "No se pudo abrir el archivo: " << nombreArchivo << endl;
-        return;
+// (si el archivo está en formato binario se delega en cargarBinario)
+bool Red::cargarDesdeArchivo(const string& nombreArchivo) {
+    if (esArchivoBinario(nombreArchivo)) return cargarBinario(nombreArchivo);
+
+    // Lectura por bloques con from_chars; la instantánea sale armada del cargador
+    MEDIR_FASE(FASE_CARGA_TEXTO);
+    GrafoCSR leido;
+    if (!cargarTopologiaTexto(nombreArchivo, leido)) return false;
+    reemplazarDesdeCSR(move(leido));
+
+    cout << "Red cargada desde: " << nombreArchivo << endl;
+    cargarJerarquia(nombreArchivo);
+    return true;
+}
+
+// Reemplaza la red actual por la de la instantánea (ids crecientes); la
+// ranura de cada enrutador es su índice en ella
+void Red::reemplazarDesdeCSR(GrafoCSR nuevo) {
+    lock_guard<mutex> candado(mEdicion);
+    vaciar();
+
+    int n = nuevo.cantidadNodos();
+    enrutadores.reserve(n);
+    ranuraDeId.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        enrutadores.emplace_back(nuevo.ids[i], &arena);
+        ranuraDeId.emplace(nuevo.ids[i], i);
     }
+    siguienteId = n > 0 ? nuevo.ids[n - 1] + 1 : 1;
+
+    // La disposición se elige antes de llenar, con la cuenta de la CSR
+    for (int i = 0; i < n; ++i)
+        for (int e = nuevo.inicio[i]; e < nuevo.inicio[i + 1]; ++e)
+            if (nuevo.destino[e] != i) ++enlacesDirigidos;
+    if (enlacesDirigidos > 0) {
+        costoMinimoEnlaces = nuevo.costoMinimo;
+        costoMaximoEnlaces = nuevo.costoMaximo;
+    }
+    ajustarAlmacenamiento();
 
-    // Limpiar red actual
-    for (auto* r : enrutadores) delete r;
-    enrutadores.clear();
+    // La CSR ya viene ordenada por vecino: cada lista se reserva y se llena al final
+    for (int i = 0; i < n; ++i) {
+        Router& r = enrutadores[i];
+        if (!densa) r.vecinos.reservar(nuevo.inicio[i + 1] - nuevo.inicio[i], &arena);
+        for (int e = nuevo.inicio[i]; e < nuevo.inicio[i + 1]; ++e) {
+            if (nuevo.destino[e] == i) continue;
+            if (densa) matriz.asignar(i, nuevo.destino[e], nuevo.costo[e]);
+            else r.nuevoVecino(nuevo.destino[e], nuevo.costo[e]);
+        }
+    }
 
-    string a, b;
-    int costo;
-    // Usamos un mapa temporal id -> Router*
-    map<int, Router*> mapa;
+    // Se publica directamente la instantánea recibida
+    versiones.publicar(nuevo);
+    versionVieja = false;
+    grafoCSR = move(nuevo);
+    numeroGrafo = versiones.numero();
+}
+
+// ============================
+// Formato binario
+// ============================
+bool Red::guardarBinario(const string& rutaArchivo) const {
+    MEDIR_FASE(FASE_GUARDADO);
+    if (!::guardarBinario(instantanea(), rutaArchivo)) return false;
+    cout << "Red guardada en formato binario en: " << rutaArchivo << endl;
+    guardarJerarquia(rutaArchivo);
+    return true;
+}
+
+bool Red::cargarBinario(const string& nombreArchivo) {
+    MEDIR_FASE(FASE_CARGA_BINARIO);
+    GrafoCSR mapeado;
+    if (!mapearBinario(nombreArchivo, mapeado)) return false;
 
-    while (archivo >> a >> b >> costo) {
-        if (a.size() < 2 || b.size() < 2) continue;
-        // quitar prefijo 'R' y convertir
-        int id1 = stoi(a.substr(1));
-        int id2 = stoi(b.substr(1));
-        if (id1 == id2) continue;
+    reemplazarDesdeCSR(move(mapeado));
 
-        if (mapa.find(id1) == mapa.end()) mapa[id1] = new Router(id1);
-        if (mapa.find(id2) == mapa.end()) mapa[id2] = new Router(id2);
+    cout << "Red cargada desde: " << nombreArchivo << endl;
+    cargarJerarquia(nombreArchivo);
+    return true;
+}
+
+// ============================
+// Jerarquía de contracción
+// ============================
+// Como las FIB, corresponde a una instantánea: cualquier edición la deja
+// vieja. En disco va junto a la topología, en <archivo>.ch
+bool Red::jerarquiaVigente() const {
+    return jerarquia && jerarquia->grafo().almacen == instantanea().almacen;
+}
 
-        mapa[id1]->nuevoVecino(mapa[id2], costo);
-        mapa[id2]->nuevoVecino(mapa[id1], costo);
+bool Red::prepararJerarquia() {
+    if (ranuraDeId.empty()) {
+        cout << "No hay enrutadores.\n";
+        return false;
+    }
+    if (jerarquiaVigente()) {
+        cout << "La jerarquía de contracción ya está al día.\n";
+        return true;
+    }
+    // Las búsquedas de testigos y la poda de la búsqueda hacia arriba
+    // suponen costos no negativos, como Dijkstra
+    if (instantanea().costoMinimo < 0) {
+        cout << "La red tiene enlaces con costo negativo: no se arma la jerarquía de contracción.\n";
+        return false;
     }
-    archivo.close();
 
-    // Insertar routers en vector en orden de id (1..N)
-    vector<int> ids;
-    for (auto& p : mapa) ids.push_back(p.first);
-    sort(ids.begin(), ids.end());
-    for (int id : ids) {
-        // garantizamos que el id interno coincida con la posición
-        Router* r = mapa[id];
-        r->id = (int)enrutadores.size() + 1; // renumerar consecutivamente
-        enrutadores.push_back(r);
+    MEDIR_FASE(FASE_JERARQUIA);
+    auto nueva = make_unique<JerarquiaContraccion>();
+    if (!nueva->construir(instantanea())) {
+        jerarquia.reset();
+        cout << "La red no tiene una jerarquía aprovechable (los atajos se multiplican, como en las redes "
+                "aleatorias); las rutas se siguen calculando con la búsqueda bidireccional.\n";
+        return false;
     }
+    jerarquia = move(nueva);
+    cout << "Jerarquía de contracción lista en " << (long long)jerarquia->msConstruccion() << " ms: "
+         << jerarquia->cantidadAtajos() << " atajos, " << jerarquia->cantidadAristas()
+         << " aristas hacia arriba. Se guarda junto a la red al guardarla.\n";
+    return true;
+}
 
-    // IMPORTANTE: los vecinos apuntan a Router* con los ids antiguos;
-    // necesitamos reindexarlos para que sus .id coincidan con la nueva numeración.
-    // Creamos un mapa viejoId -> nuevoPointer
-    map<int, Router*> nuevoMapa;
-    for (auto* r : enrutadores) nuevoMapa[r->id] = r; // ahora r->id es posición, pero vecinos tienen ptrs con old ids
-    // No podemos determinar old ids facilmente desde los punteros si no las actualizamos.
-    // Por simplicidad, asumimos que los archivos vienen con IDs consecutivos 1..N y las referencias por pointer siguen siendo válidas.
-    // Si en tu formato necesitas preservar IDs tal cual, se puede adaptar.
+void Red::guardarJerarquia(const string& rutaTopologia) const {
+    string ruta = rutaTopologia + ".ch";
+    if (!jerarquiaVigente()) {
+        remove(ruta.c_str()); // la de una versión anterior del archivo ya no sirve
+        return;
+    }
+    if (jerarquia->guardar(ruta))
+        cout << "Jerarquía de contracción guardada en: " << ruta << endl;
+}
 
-    cout << "Red cargada desde: " << nombreArchivo << endl;
+void Red::cargarJerarquia(const string& rutaTopologia) {
+    string ruta = rutaTopologia + ".ch";
+    if (!ifstream(ruta)) return;
+    auto cargada = make_unique<JerarquiaContraccion>();
+    if (!cargada->cargar(ruta, instantanea())) {
+        cout << "Se ignora " << ruta << ": no corresponde a esta red.\n";
+        return;
+    }
+    jerarquia = move(cargada);
+    cout << "Jerarquía de contracción cargada desde: " << ruta << endl;
+}
+
+bool Red::exportarRutas(const string& nombreArchivo, FormatoExportacion formato,
+                        ContenidoExportacion contenido) const {
+    // Con la caché al día las filas se copian; si no, se calculan por bloques
+    const MatrizTodosLosPares* cache = rutas.valida() ? &rutas.tablas() : nullptr;
+    MEDIR_FASE(FASE_EXPORTACION);
+    auto t0 = chrono::steady_clock::now();
+    if (!::exportarRutas(instantanea(), cache, obtenerPool(), nombreArchivo, formato, contenido))
+        return false;
+    double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    cout << (contenido == ContenidoExportacion::Tablas ? "Tablas de enrutamiento" : "Matriz de costos")
+         << " exportada en " << nombreArchivo << " (" << (long long)ms << " ms)" << endl;
+    return true;
 }
 
 // ============================
 // Gestión de enrutadores
 // ============================
 void Red::agregarEnrutador() {
-    int nuevoId = enrutadores.size() + 1;
-    enrutadores.push_back(new Router(nuevoId));
+    bool habiaSimulacion = vectorDistancia != nullptr;
+    int nuevoId = crearEnrutador();
     cout << "Enrutador R" << nuevoId << " agregado.\n";
+    if (habiaSimulacion) cout << "La simulación de vector distancia se descartó.\n";
 }
 
 void Red::eliminarEnrutador(int id) {
-    if (id <= 0 || id > (int)enrutadores.size()) {
+    bool habiaSimulacion = vectorDistancia != nullptr;
+    if (!quitarEnrutador(id)) {
         cout << "ID inválido.\n";
         return;
     }
+    cout << "Enrutador R" << id << " eliminado.\n";
+    if (habiaSimulacion) cout << "La simulación de vector distancia se descartó.\n";
+    if (estadoEnlace) {
+        cout << "Inundación de estado de enlace:\n";
+        mostrarInformeLS(ultimoInformeLS);
+    }
+}
 
-    Router* aEliminar = enrutadores[id - 1];
-
-    // eliminar referencias de vecinos
-    for (auto* r : enrutadores) {
-        if (r != aEliminar) r->eliminarVecino(aEliminar);
+int Red::crearEnrutador() {
+    int nuevoId;
+    {
+        lock_guard<mutex> candado(mEdicion);
+        nuevoId = siguienteId++;
+        ocuparRanura(nuevoId);
+        versionVieja = true;
     }
+    // Su id es el mayor: en la instantánea queda al final
+    if (rutas.valida()) rutas.enrutadorAgregado(instantanea());
+    vectorDistancia.reset(); // las tablas simuladas tienen un tamaño fijo
+    return nuevoId;
+}
+
+bool Red::quitarEnrutador(int id) {
+    int ranura = ranuraDe(id);
+    if (ranura < 0) return false;
 
-    delete aEliminar;
-    enrutadores.erase(enrutadores.begin() + (id - 1));
+    // Posición en la instantánea anterior: la caché compacta esa fila y columna
+    int indice = rutas.valida() ? indiceDeId(rutas.grafo(), id) : -1;
 
-    // reajustar ids para que sean consecutivos 1..N
-    for (size_t i = 0; i < enrutadores.size(); ++i)
-        enrutadores[i]->id = (int)i + 1;
+    // Los vecinos notan la caída y originan los LSA
+    vector<int> vecinosLS;
+    if (estadoEnlace) {
+        vector<Vecino> vecinos;
+        vecinosDe(ranura, vecinos);
+        for (const Vecino& v : vecinos) vecinosLS.push_back(enrutadores[v.indice].id);
+    }
 
-    cout << "Enrutador R" << id << " eliminado y IDs reajustados.\n";
+    {
+        lock_guard<mutex> candado(mEdicion);
+        // Solo se tocan los enlaces de sus vecinos; la ranura queda libre
+        liberarRanura(ranura);
+        ajustarAlmacenamiento();
+        versionVieja = true;
+    }
+    if (rutas.valida()) rutas.enrutadorEliminado(instantanea(), indice, obtenerPool());
+    vectorDistancia.reset();
+    if (estadoEnlace) {
+        const GrafoCSR& grafo = instantanea();
+        vector<int> origenesLS;
+        for (int vecino : vecinosLS) origenesLS.push_back(indiceDeId(grafo, vecino));
+        topologiaCambiadaLS(origenesLS);
+    }
+    return true;
 }
 
 // ============================
@@ -286,22 +670,30 @@ void Red::agregarEnlace() {
     cin >> id2;
     cout << "Ingrese el costo del enlace: ";
     cin >> costo;
-
-    if (id1 <= 0 || id2 <= 0 || id1 > (int)enrutadores.size() || id2 > (int)enrutadores.size()) {
-        cout << "IDs inválidos.\n";
+    if (cin.fail()) {
+        cin.clear();
+        cin.ignore(numeric_limits<streamsize>::max(), '\n');
+        cout << "Entrada inválida.\n";
         return;
     }
+
     if (id1 == id2) {
         cout << "No se puede conectar un enrutador consigo mismo.\n";
         return;
     }
-
-    Router* r1 = enrutadores[id1 - 1];
-    Router* r2 = enrutadores[id2 - 1];
-    r1->nuevoVecino(r2, costo);
-    r2->nuevoVecino(r1, costo);
-
+    if (!conectar(id1, id2, costo)) {
+        cout << "IDs inválidos o costo negativo.\n";
+        return;
+    }
     cout << "Enlace agregado entre R" << id1 << " y R" << id2 << ".\n";
+    if (vectorDistancia) {
+        cout << "Reconvergencia del vector distancia:\n";
+        mostrarInformeVD(ultimoInformeVD);
+    }
+    if (estadoEnlace) {
+        cout << "Inundación de estado de enlace:\n";
+        mostrarInformeLS(ultimoInformeLS);
+    }
 }
 
 void Red::eliminarEnlace() {
@@ -311,88 +703,317 @@ void Red::eliminarEnlace() {
     cout << "Ingrese el ID del segundo enrutador: ";
     cin >> id2;
 
-    if (id1 <= 0 || id2 <= 0 || id1 > (int)enrutadores.size() || id2 > (int)enrutadores.size()) {
+    if (!desconectar(id1, id2)) {
         cout << "IDs inválidos.\n";
         return;
     }
+    cout << "Enlace eliminado entre R" << id1 << " y R" << id2 << ".\n";
+    if (vectorDistancia) {
+        cout << "Reconvergencia del vector distancia:\n";
+        mostrarInformeVD(ultimoInformeVD);
+    }
+    if (estadoEnlace) {
+        cout << "Inundación de estado de enlace:\n";
+        mostrarInformeLS(ultimoInformeLS);
+    }
+}
 
-    Router* r1 = enrutadores[id1 - 1];
-    Router* r2 = enrutadores[id2 - 1];
-    r1->eliminarVecino(r2);
-    r2->eliminarVecino(r1);
+// Misma regla que aplicarEdiciones: los costos negativos no son del dominio
+bool Red::conectar(int id1, int id2, int costo) {
+    int ranura1 = ranuraDe(id1), ranura2 = ranuraDe(id2);
+    if (ranura1 < 0 || ranura2 < 0 || ranura1 == ranura2 || costo < 0) return false;
+
+    int costoAnterior = costoEntre(ranura1, ranura2);
+    {
+        lock_guard<mutex> candado(mEdicion);
+        fijarEnlace(ranura1, ranura2, costo);
+        ajustarAlmacenamiento();
+        versionVieja = true;
+    }
+    enlaceCambiado(id1, id2, costoAnterior, costo);
+    return true;
+}
 
-    cout << "Enlace eliminado entre R" << id1 << " y R" << id2 << ".\n";
+bool Red::desconectar(int id1, int id2) {
+    int ranura1 = ranuraDe(id1), ranura2 = ranuraDe(id2);
+    if (ranura1 < 0 || ranura2 < 0) return false;
+
+    int costoAnterior = costoEntre(ranura1, ranura2);
+    {
+        lock_guard<mutex> candado(mEdicion);
+        quitarEnlace(ranura1, ranura2);
+        ajustarAlmacenamiento();
+        versionVieja = true;
+    }
+    enlaceCambiado(id1, id2, costoAnterior, INFINITO);
+    return true;
+}
+
+// Caché de rutas y simulaciones siguen al enlace, con los índices de la
+// instantánea nueva (solo se arma si alguna lo necesita)
+void Red::enlaceCambiado(int id1, int id2, int costoAnterior, int costoNuevo) {
+    if (!rutas.valida() && !vectorDistancia && !estadoEnlace) return;
+    const GrafoCSR& grafo = instantanea();
+    int i1 = indiceDeId(grafo, id1), i2 = indiceDeId(grafo, id2);
+    if (rutas.valida())
+        rutas.enlaceCambiado(grafo, i1, i2, costoAnterior, costoNuevo, obtenerPool());
+    enlaceCambiadoVD(i1, i2);
+    topologiaCambiadaLS({i1, i2});
+}
+
+// ============================
+// Ediciones en lote
+// ============================
+// Clave de un enlace sin orientación: (menor id, mayor id)
+static uint64_t claveEnlace(int a, int b) {
+    if (a > b) swap(a, b);
+    return (uint64_t)(uint32_t)a << 32 | (uint32_t)b;
+}
+
+ResultadoEdiciones Red::aplicarEdiciones(const vector<Edicion>& ediciones) {
+    ResultadoEdiciones resultado;
+
+    // Validación: el lote se simula en orden sin tocar la red. De cada enlace
+    // queda solo el estado final (QUITAR_VECINO = quitado)
+    int proximoId = siguienteId;
+    unordered_set<int> eliminados;
+    unordered_map<uint64_t, int> pendientes;
+    auto vive = [&](int id) {
+        if (eliminados.count(id)) return false;
+        return ranuraDe(id) >= 0 || (id >= siguienteId && id < proximoId);
+    };
+    auto existe = [&](int a, int b) {
+        auto it = pendientes.find(claveEnlace(a, b));
+        if (it != pendientes.end()) return it->second != QUITAR_VECINO;
+        int ra = ranuraDe(a), rb = ranuraDe(b);
+        return ra >= 0 && rb >= 0 && costoEntre(ra, rb) != INFINITO;
+    };
+
+    for (size_t k = 0; k < ediciones.size(); ++k) {
+        const Edicion& e = ediciones[k];
+        string error;
+        if (e.tipo == TipoEdicion::AgregarEnrutador) {
+            resultado.idsNuevos.push_back(proximoId++);
+        } else if (!vive(e.id1)) {
+            error = "R" + to_string(e.id1) + " no existe";
+        } else if (e.tipo == TipoEdicion::EliminarEnrutador) {
+            eliminados.insert(e.id1);
+        } else if (!vive(e.id2)) {
+            error = "R" + to_string(e.id2) + " no existe";
+        } else if (e.id1 == e.id2) {
+            error = "un enrutador no se conecta consigo mismo";
+        } else if (e.tipo != TipoEdicion::Desconectar && e.costo < 0) {
+            error = "costo negativo";
+        } else if (e.tipo != TipoEdicion::Conectar && !existe(e.id1, e.id2)) {
+            error = "no existe el enlace R" + to_string(e.id1) + " - R" + to_string(e.id2);
+        } else {
+            pendientes[claveEnlace(e.id1, e.id2)] = e.tipo == TipoEdicion::Desconectar ? QUITAR_VECINO : e.costo;
+        }
+        if (!error.empty()) {
+            resultado.fallida = k;
+            resultado.error = move(error);
+            resultado.idsNuevos.clear();
+            return resultado;
+        }
+    }
+
+    // Cambios por ranura, en ambos sentidos; 'extremos' son los ids que notan
+    // algún cambio (para la caché y las simulaciones)
+    struct Cambio {
+        int ranura;
+        Vecino vecino;
+    };
+    vector<Cambio> cambios;
+    vector<int> extremos;
+    {
+        lock_guard<mutex> candado(mEdicion);
+
+        for (int id : resultado.idsNuevos) ocuparRanura(id);
+        siguienteId = proximoId;
+
+        // Se descartan los enlaces de enrutadores eliminados y los que ya
+        // estaban como quedan
+        int costoMinimoLote = INT_MAX, costoMaximoLote = INT_MIN;
+        for (auto& [clave, costo] : pendientes) {
+            int a = (int)(clave >> 32), b = (int)(uint32_t)clave;
+            if (eliminados.count(a) || eliminados.count(b)) continue;
+            int ra = ranuraDe(a), rb = ranuraDe(b);
+            int actual = costoEntre(ra, rb);
+            if (costo == QUITAR_VECINO ? actual == INFINITO : actual == costo) continue;
+            if (costo == QUITAR_VECINO) {
+                enlacesDirigidos -= 2;
+            } else {
+                if (actual == INFINITO) enlacesDirigidos += 2;
+                costoMinimoLote = min(costoMinimoLote, costo);
+                costoMaximoLote = max(costoMaximoLote, costo);
+            }
+            cambios.push_back({ra, {rb, costo}});
+            cambios.push_back({rb, {ra, costo}});
+            extremos.push_back(a);
+            extremos.push_back(b);
+            ++resultado.enlacesCambiados;
+        }
+        vector<Vecino> vecinos;
+        for (int id : eliminados) {
+            int ranura = ranuraDe(id);
+            vecinosDe(ranura, vecinos);
+            for (const Vecino& v : vecinos) {
+                int vecino = enrutadores[v.indice].id;
+                if (eliminados.count(vecino)) continue;
+                cambios.push_back({v.indice, {ranura, QUITAR_VECINO}});
+                extremos.push_back(vecino);
+            }
+        }
+
+        // Con la matriz cada cambio es una celda; si algún costo del lote no
+        // entra en el ancho actual se ensancha o se vuelve a las listas
+        if (costoMinimoLote <= costoMaximoLote) {
+            costoMinimoEnlaces = min(costoMinimoEnlaces, costoMinimoLote);
+            costoMaximoEnlaces = max(costoMaximoEnlaces, costoMaximoLote);
+            if (densa && (!matriz.cabe(costoMinimoLote) || !matriz.cabe(costoMaximoLote))) {
+                if (MatrizCostos::anchoPara(costoMinimoLote, costoMaximoLote) == 2) matriz.ensanchar();
+                else pasarADispersa();
+            }
+        }
+        if (densa) {
+            for (const Cambio& c : cambios) {
+                if (c.vecino.costo == QUITAR_VECINO) matriz.quitar(c.ranura, c.vecino.indice);
+                else matriz.asignar(c.ranura, c.vecino.indice, c.vecino.costo);
+            }
+        } else {
+            // Con listas, una pasada por lista: los cambios de cada ranura,
+            // ordenados, se fusionan con sus vecinos actuales
+            sort(cambios.begin(), cambios.end(), [](const Cambio& x, const Cambio& y) {
+                return x.ranura != y.ranura ? x.ranura < y.ranura : x.vecino.indice < y.vecino.indice;
+            });
+            vector<Vecino> tramo;
+            for (size_t i = 0; i < cambios.size();) {
+                size_t j = i;
+                tramo.clear();
+                while (j < cambios.size() && cambios[j].ranura == cambios[i].ranura) tramo.push_back(cambios[j++].vecino);
+                enrutadores[cambios[i].ranura].vecinos.fusionar(tramo.data(), tramo.size(), &arena);
+                i = j;
+            }
+        }
+
+        // Los vecinos ya no los tienen: liberar la ranura solo descuenta sus enlaces
+        for (int id : eliminados) liberarRanura(ranuraDe(id));
+        ajustarAlmacenamiento();
+
+        if (!cambios.empty() || !resultado.idsNuevos.empty() || !eliminados.empty()) versionVieja = true;
+    }
+    resultado.aplicado = true;
+
+    // Estado derivado, una vez por lote: la caché se recalcula entera (las
+    // reparaciones incrementales suponen un solo enlace cambiado)
+    bool cambiaronEnrutadores = !resultado.idsNuevos.empty() || !eliminados.empty();
+    if (cambios.empty() && !cambiaronEnrutadores) return resultado;
+    if (rutas.valida()) rutas.recalcular(instantanea(), obtenerPool());
+    if (cambiaronEnrutadores) vectorDistancia.reset();
+    if (vectorDistancia || estadoEnlace) {
+        const GrafoCSR& grafo = instantanea();
+        sort(extremos.begin(), extremos.end());
+        extremos.erase(unique(extremos.begin(), extremos.end()), extremos.end());
+        for (int& x : extremos) x = indiceDeId(grafo, x);
+        if (vectorDistancia) ultimoInformeVD = vectorDistancia->enlacesCambiados(grafo, extremos, obtenerPool());
+        topologiaCambiadaLS(extremos);
+    }
+    return resultado;
 }
 
 // ============================
 // Mostrar tablas de enrutamiento
 // ============================
-void Red::mostrarTablasDeEnrutamiento() {
-    if (enrutadores.empty()) {
+// Agrega 'texto' a la línea ocupando al menos 'ancho' columnas (como setw con left)
+static void agregarColumna(string& linea, string_view texto, size_t ancho) {
+    linea += texto;
+    if (texto.size() < ancho) linea.append(ancho - texto.size(), ' ');
+}
+
+static string_view enTexto(int valor, char (&bufer)[16]) {
+    auto fin = to_chars(bufer, bufer + sizeof bufer, valor).ptr;
+    return string_view(bufer, fin - bufer);
+}
+
+void Red::mostrarTablasDeEnrutamiento(const vector<int>& ids) {
+    MEDIR_FASE(FASE_TABLAS);
+    if (ranuraDeId.empty()) {
         cout << "No hay enrutadores.\n";
         return;
     }
 
+    // Para todas las tablas se usa la caché (solo se recalcula si no está al
+    // día; las ediciones la reparan). Para unos pocos orígenes sin caché
+    // alcanza con un Dijkstra por origen
+    if (ids.empty() && !rutas.valida()) rutas.recalcular(instantanea(), obtenerPool());
+    const GrafoCSR& grafo = rutas.valida() ? rutas.grafo() : instantanea();
+    int n = grafo.cantidadNodos();
+
+    vector<int> origenes;
+    for (int id : ids) {
+        int indice = indiceDeId(grafo, id);
+        if (indice < 0) cout << "ID inválido: " << id << "\n";
+        else origenes.push_back(indice);
+    }
+    if (!ids.empty() && origenes.empty()) return;
+    if (ids.empty()) {
+        origenes.resize(n);
+        iota(origenes.begin(), origenes.end(), 0);
+    }
+
+    vector<int> dist(n), prev(n), camino;
+    EspacioDijkstra espacio;
+    string tabla;      // se arma una tabla entera y se escribe de una vez
+    char numero[16];
+    auto agregarNombre = [&](int i) {
+        tabla += 'R';
+        tabla += enTexto(grafo.ids[i], numero);
+    };
+
     cout << "\n========= TABLAS DE ENRUTAMIENTO =========\n";
-    for (auto* origen : enrutadores) {
-        string nombreOrigen = origen->getNombre();
-
-        map<string,int> dist;
-        map<string,string> prev;
-        for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-        dist[nombreOrigen] = 0;
-
-        priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-        pq.push({0, nombreOrigen});
-
-        while (!pq.empty()) {
-            auto [d, actual] = pq.top(); pq.pop();
-            if (d > dist[actual]) continue;
-            Router* r_actual = nullptr;
-            for (auto* r : enrutadores) if (r->getNombre() == actual) { r_actual = r; break; }
-            if (!r_actual) continue;
-            for (auto& p : r_actual->vecinos) {
-                Router* vec = p.first;
-                int c = p.second;
-                string nombreVec = "R" + to_string(vec->id);
-                if (dist[actual] + c < dist[nombreVec]) {
-                    dist[nombreVec] = dist[actual] + c;
-                    prev[nombreVec] = actual;
-                    pq.push({dist[nombreVec], nombreVec});
-                }
-            }
+    for (int o : origenes) {
+        const int* filaDist;
+        if (rutas.valida()) {
+            filaDist = rutas.tablas().filaDist(o);
+            rutas.tablas().copiarFilaPrev(o, prev.data());
+        } else {
+            dijkstra(grafo, o, dist.data(), prev.data(), espacio);
+            filaDist = dist.data();
         }
 
-        cout << "Tabla de " << nombreOrigen << ":\n";
+        cout << "Tabla de " << grafo.nombre(o) << ":\n";
         cout << left << setw(10) << "Destino" << setw(10) << "Costo" << "Camino\n";
         cout << string(50, '-') << "\n";
-        for (auto* destino : enrutadores) {
-            string nombreDest = destino->getNombre();
-            if (nombreDest == nombreOrigen) {
-                cout << setw(10) << nombreDest << setw(10) << 0 << "-" << "\n";
+        tabla.clear();
+        for (int d = 0; d < n; ++d) {
+            size_t inicioLinea = tabla.size();
+            agregarNombre(d);
+            size_t largo = tabla.size() - inicioLinea;
+            if (largo < 10) tabla.append(10 - largo, ' ');
+
+            if (d == o) {
+                agregarColumna(tabla, "0", 10);
+                tabla += "-\n";
                 continue;
             }
-            if (dist[nombreDest] == INT_MAX) {
-                cout << setw(10) << nombreDest << setw(10) << "-" << "Sin conexión\n";
+            if (filaDist[d] == INFINITO) {
+                agregarColumna(tabla, "-", 10);
+                tabla += "Sin conexión\n";
                 continue;
             }
-            // reconstruir camino
-            vector<string> ruta;
-            string cur = nombreDest;
-            while (prev.find(cur) != prev.end()) {
-                ruta.push_back(cur);
-                cur = prev[cur];
-            }
-            ruta.push_back(nombreOrigen);
-            reverse(ruta.begin(), ruta.end());
-            string camino;
-            for (size_t i = 0; i < ruta.size(); ++i) {
-                camino += ruta[i];
-                if (i + 1 < ruta.size()) camino += " -> ";
+            agregarColumna(tabla, enTexto(filaDist[d], numero), 10);
+
+            // El camino se arma solo para mostrarlo, subiendo por los predecesores
+            camino.clear();
+            for (int x = d; x != -1 && x != o; x = prev[x]) camino.push_back(x);
+            camino.push_back(o);
+            for (size_t i = camino.size(); i-- > 0;) {
+                agregarNombre(camino[i]);
+                if (i > 0) tabla += " -> ";
             }
-            cout << setw(10) << nombreDest << setw(10) << dist[nombreDest] << camino << "\n";
+            tabla += '\n';
         }
-        cout << "\n";
+        cout << tabla << "\n";
     }
     cout << "==========================================\n";
 }
@@ -401,61 +1022,192 @@ void Red::mostrarTablasDeEnrutamiento() {
 // Calcular ruta más corta entre dos enrutadores
 // ============================
 void Red::calcularRutaMasCorta(int origenId, int destinoId) {
-    if (origenId <= 0 || destinoId <= 0 ||
-        origenId > (int)enrutadores.size() || destinoId > (int)enrutadores.size()) {
+    MEDIR_FASE(FASE_RUTA_MAS_CORTA);
+    if (ranuraDe(origenId) < 0 || ranuraDe(destinoId) < 0) {
         cout << "IDs inválidos.\n";
         return;
     }
 
-    Router* origen = enrutadores[origenId - 1];
-    Router* destino = enrutadores[destinoId - 1];
-
-    map<string,int> dist;
-    map<string,string> prev;
-    string nombreOrigen = origen->getNombre();
-    string nombreDestino = destino->getNombre();
-
-    for (auto* r : enrutadores) dist[r->getNombre()] = INT_MAX;
-    dist[nombreOrigen] = 0;
-
-    priority_queue<pair<int,string>, vector<pair<int,string>>, greater<pair<int,string>>> pq;
-    pq.push({0, nombreOrigen});
-
-    while (!pq.empty()) {
-        auto [d, actual] = pq.top(); pq.pop();
-        if (d > dist[actual]) continue;
-        Router* r_actual = nullptr;
-        for (auto* r : enrutadores) if (r->getNombre() == actual) { r_actual = r; break; }
-        if (!r_actual) continue;
-        for (auto& p : r_actual->vecinos) {
-            Router* vec = p.first; int c = p.second;
-            string nombreVec = "R" + to_string(vec->id);
-            if (dist[actual] + c < dist[nombreVec]) {
-                dist[nombreVec] = dist[actual] + c;
-                prev[nombreVec] = actual;
-                pq.push({dist[nombreVec], nombreVec});
-            }
-        }
+    const GrafoCSR& grafo = instantanea();
+    int origen = indiceDeId(grafo, origenId);
+    int destino = indiceDeId(grafo, destinoId);
+    string nombreOrigen = grafo.nombre(origen);
+    string nombreDestino = grafo.nombre(destino);
+
+    // Con las tablas en caché la respuesta sale directa de la fila del origen;
+    // si no, con la jerarquía de contracción si está al día, y si no,
+    // búsqueda bidireccional que se detiene al unirse las fronteras
+    if (jerarquia && !jerarquiaVigente()) {
+        jerarquia.reset();
+        cout << "La jerarquía de contracción quedó vieja por las ediciones; se descarta.\n";
+    }
+    vector<int> ruta;
+    int costo;
+    if (rutas.valida()) {
+        costo = rutas.tablas().filaDist(origen)[destino];
+        if (costo != INFINITO) rutas.tablas().camino(origen, destino, ruta);
+    } else if (jerarquia) {
+        costo = jerarquia->ruta(origen, destino, ruta, espacioJerarquia);
+    } else {
+        costo = rutaBidireccional(grafo, origen, destino, ruta, espacioRuta);
     }
 
-    if (dist[nombreDestino] == INT_MAX) {
+    if (costo == INFINITO) {
         cout << "No existe ruta entre " << nombreOrigen << " y " << nombreDestino << ".\n";
         return;
     }
 
-    vector<string> ruta;
-    string cur = nombreDestino;
-    while (prev.find(cur) != prev.end()) {
-        ruta.push_back(cur);
-        cur = prev[cur];
-    }
-    ruta.push_back(nombreOrigen);
-    reverse(ruta.begin(), ruta.end());
-
     cout << "Ruta mas corta: ";
     for (size_t i = 0; i < ruta.size(); ++i) {
-        cout << ruta[i];
+        cout << grafo.nombre(ruta[i]);
         if (i + 1 < ruta.size()) cout << " -> ";
     }
-    cout << " | Costo total: " << dist[nombreDestino] << "\n";
+    cout << " | Costo total: " << costo << "\n";
+}
+
+// ============================
+// Simulación de vector distancia
+// ============================
+void Red::simularVectorDistancia(const ConfiguracionVD& configuracion) {
+    if (ranuraDeId.empty()) {
+        cout << "No hay enrutadores.\n";
+        return;
+    }
+    if ((int)ranuraDeId.size() > MAX_NODOS_VD) {
+        cout << "La simulación admite hasta " << MAX_NODOS_VD << " enrutadores.\n";
+        return;
+    }
+    vectorDistancia = make_unique<SimuladorVectorDistancia>(instantanea(), configuracion);
+    InformeVD informe = vectorDistancia->converger(obtenerPool());
+    cout << "Vector distancia desde el arranque (infinito = " << vectorDistancia->infinito()
+         << (configuracion.horizonteDividido ? ", con horizonte dividido" : "") << "):\n";
+    mostrarInformeVD(informe);
+    cout << "Las ediciones de enlaces se propagan ahora por el protocolo simulado.\n";
+}
+
+// La simulación sigue a la red: cada cambio de enlace se reconverge desde las tablas actuales
+void Red::enlaceCambiadoVD(int indice1, int indice2) {
+    if (!vectorDistancia) return;
+    ultimoInformeVD = vectorDistancia->enlaceCambiado(instantanea(), indice1, indice2, obtenerPool());
+}
+
+void Red::mostrarInformeVD(const InformeVD& informe) const {
+    cout << "  Rondas: " << informe.rondas << (informe.convergio ? "" : " (sin converger, se alcanzó el máximo)") << "\n";
+    cout << "  Mensajes: " << informe.mensajes << "\n";
+    cout << "  Entradas actualizadas: " << informe.entradasCambiadas << "\n";
+    if (informe.cuentaAlInfinito > 0)
+        cout << "  Cuenta al infinito: " << informe.cuentaAlInfinito
+             << " entradas subieron hasta quedar inalcanzables (la peor durante "
+             << informe.mayorCuenta << " rondas)\n";
+    cout << "  Tiempo: " << fixed << setprecision(2) << informe.ms << " ms\n";
+    cout.unsetf(ios::fixed);
+}
+
+void Red::mostrarTablasVectorDistancia() const {
+    if (!vectorDistancia) {
+        cout << "Primero ejecute la simulación de vector distancia.\n";
+        return;
+    }
+    const GrafoCSR& grafo = instantanea();
+    for (int i = 0; i < vectorDistancia->cantidadNodos(); ++i)
+        enrutadores[ranuraDe(grafo.ids[i])].mostrarTablaEnrutamiento(vectorDistancia->tabla(i));
+}
+
+// ============================
+// Simulación de estado de enlace
+// ============================
+void Red::simularEstadoEnlace(const ConfiguracionLS& configuracion) {
+    estadoEnlace = make_unique<SimuladorEstadoEnlace>(configuracion);
+    cout << "Simulación de estado de enlace activa: al agregar o eliminar enlaces o enrutadores\n"
+         << "se inundan los LSA y se informa cuándo converge cada enrutador.\n";
+}
+
+void Red::topologiaCambiadaLS(const vector<int>& origenes) {
+    if (!estadoEnlace) return;
+    ultimoInformeLS = estadoEnlace->simular(instantanea(), origenes);
+}
+
+void Red::mostrarInformeLS(const InformeLS& informe) const {
+    const int MAX_LISTADO = 20; // con más enrutadores solo se listan los más lentos
+    const GrafoCSR& grafo = instantanea();
+
+    vector<int> afectados;
+    for (int i = 0; i < (int)informe.convergencia.size(); ++i)
+        if (informe.convergencia[i] >= 0) afectados.push_back(i);
+    sort(afectados.begin(), afectados.end(), [&](int a, int b) {
+        return informe.convergencia[a] > informe.convergencia[b];
+    });
+    auto percentil = [&](int p) {
+        return informe.convergencia[afectados[(afectados.size() - 1) * (100 - p) / 100]];
+    };
+
+    cout << fixed << setprecision(2);
+    cout << "  LSA originados: " << informe.lsas << ", mensajes: " << informe.mensajes
+         << ", duplicados descartados: " << informe.duplicados << "\n";
+    cout << "  Cálculos SPF: " << informe.ejecucionesSPF << ", enrutadores afectados: " << afectados.size() << "\n";
+    if (!afectados.empty()) {
+        cout << "  Convergencia de la red: " << informe.total << " ms (mediana " << percentil(50)
+             << ", p90 " << percentil(90) << ", p99 " << percentil(99) << ")\n";
+        bool todos = (int)afectados.size() <= MAX_LISTADO;
+        cout << (todos ? "  Convergencia por enrutador:\n" : "  Enrutadores más lentos:\n");
+        for (int k = 0; k < (int)afectados.size() && k < MAX_LISTADO; ++k)
+            cout << "    " << grafo.nombre(afectados[k]) << ": " << informe.convergencia[afectados[k]] << " ms\n";
+    }
+    cout << "  Eventos: " << informe.eventos << " en " << informe.ms << " ms reales";
+    if (informe.ms > 0) cout << " (" << (long long)(informe.eventos / informe.ms * 1000) << " eventos/s)";
+    cout << "\n";
+    cout.unsetf(ios::fixed);
+}
+
+// ============================
+// Plano de datos
+// ============================
+void Red::simularTrafico(const ConfiguracionTrafico& configuracion) {
+    if (ranuraDeId.empty()) {
+        cout << "No hay enrutadores.\n";
+        return;
+    }
+
+    // La FIB se arma una vez por instantánea: cualquier edición rehace la instantánea
+    const GrafoCSR& grafo = instantanea();
+    bool nueva = !fib || fib->grafo().almacen != grafo.almacen;
+    if (nueva) {
+        fib = make_unique<TablaReenvio>();
+        if (!fib->construir(grafo, obtenerPool())) {
+            fib.reset();
+            cout << "La red es demasiado grande para las FIB densas (máximo "
+                 << (MAX_BYTES_FIB >> 20) << " MB o 65534 vecinos por enrutador).\n";
+            return;
+        }
+    }
+
+    InformeTrafico informe = ::simularTrafico(*fib, configuracion, obtenerPool());
+
+    cout << fixed << setprecision(2);
+    cout << "  FIB: " << fib->cantidadNodos() << " x " << fib->cantidadNodos() << " entradas de "
+         << fib->anchoEntrada() << (fib->anchoEntrada() == 1 ? " byte" : " bytes") << " ("
+         << fib->bytes() / 1048576.0 << " MB), ";
+    if (nueva) cout << "construida en " << fib->msConstruccion() << " ms\n";
+    else cout << "reutilizada\n";
+    cout << "  Paquetes: " << informe.paquetes << " en " << informe.ms << " ms";
+    if (informe.ms > 0) cout << " (" << (long long)(informe.paquetes / informe.ms * 1000) << " paquetes/s)";
+    cout << "\n";
+    cout << "  Entregados: " << informe.entregados << ", sin ruta: " << informe.sinRuta
+         << ", descartados por TTL: " << informe.bucles << "\n";
+    if (informe.entregados > 0) {
+        // Percentiles de saltos a partir del histograma
+        auto percentil = [&](double p) {
+            long long objetivo = (long long)(p * (informe.entregados - 1)), acumulado = 0;
+            for (size_t s = 0; s < informe.histograma.size(); ++s) {
+                acumulado += informe.histograma[s];
+                if (acumulado > objetivo) return (int)s;
+            }
+            return (int)informe.histograma.size() - 1;
+        };
+        cout << "  Saltos: media " << (double)informe.saltos / informe.entregados
+             << ", mediana " << percentil(0.5) << ", p99 " << percentil(0.99)
+             << ", máximo " << informe.histograma.size() - 1 << "\n";
+        cout << "  Costo medio del camino: " << (double)informe.costo / informe.entregados << "\n";
+    }
+    cout.unsetf(ios::fixed);
 }
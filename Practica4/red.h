@@ -9,11 +9,105 @@
 #include <queue>
 #include <climits>
 #include <iomanip>
+#include <memory>
+#include <memory_resource>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include "cacherutas.h"
+#include "bidireccional.h"
+#include "generadores.h"
+#include "vectordistancia.h"
+#include "estadoenlace.h"
+#include "reenvio.h"
+#include "exportacion.h"
+#include "versiones.h"
+#include "jerarquia.h"
+#include "matrizcostos.h"
+
+// Referencia a un enrutador que sobrevive a las ediciones: deja de valer
+// cuando el enrutador se elimina, aunque su ranura se reutilice después
+struct ReferenciaEnrutador {
+    int ranura = -1;
+    uint32_t generacion = 0;
+};
+
+// Una edición de un lote (ver Red::aplicarEdiciones)
+enum class TipoEdicion {
+    AgregarEnrutador,   // toma el id siguiente; las ediciones posteriores del lote pueden usarlo
+    EliminarEnrutador,  // id1, con todos sus enlaces
+    Conectar,           // id1 - id2 con 'costo': crea el enlace o cambia su costo
+    CambiarCosto,       // id1 - id2 con 'costo': el enlace tiene que existir
+    Desconectar         // id1 - id2: el enlace tiene que existir
+};
+
+struct Edicion {
+    TipoEdicion tipo;
+    int id1 = 0;
+    int id2 = 0;
+    int costo = 0;
+};
+
+struct ResultadoEdiciones {
+    bool aplicado = false;
+    size_t fallida = 0;          // posición de la primera edición inválida (si no se aplicó)
+    std::string error;
+    std::vector<int> idsNuevos;  // ids de los enrutadores agregados, en orden
+    size_t enlacesCambiados = 0; // enlaces distintos que cambiaron, sin contar repetidos
+};
 
 class Red {
 private:
-    std::vector<Router*> enrutadores; // Lista de enrutadores de la red
+    std::pmr::unsynchronized_pool_resource arena; // Memoria de las listas de vecinos
+    std::vector<Router> enrutadores;  // Tabla de ranuras; las libres quedan con id 0
+    std::vector<int> ranurasLibres;   // Se reutilizan al crear enrutadores
+    std::unordered_map<int, int> ranuraDeId; // id -> ranura de los enrutadores vivos
+    int siguienteId = 1;              // Los ids no se reutilizan: siempre el mayor + 1
+    MatrizCostos matriz;              // Adyacencia densa por ranura (si 'densa'; si no, Router::vecinos)
+    bool densa = false;
+    size_t enlacesDirigidos = 0;      // Entradas de adyacencia (2 por enlace)
+    int costoMinimoEnlaces = INT_MAX; // Cotas de los costos para elegir el ancho de la matriz
+    int costoMaximoEnlaces = INT_MIN;
     std::string rutaArchivo;          // Ruta del archivo de guardado (opcional)
+    int hilos = 0;                    // Hilos para los cálculos de todos los pares (0 = automático)
+    mutable std::unique_ptr<PoolHilos> pool; // Se crea en el primer cálculo paralelo
+    CacheRutas rutas;                 // Árboles de rutas más cortas, reparados en cada edición
+    mutable std::mutex mEdicion;      // Serializa los cambios de 'enrutadores' con la publicación de versiones
+    mutable PublicadorVersiones versiones; // Instantáneas CSR publicadas para lectores de otros hilos
+    mutable std::atomic<bool> versionVieja{true}; // Hubo ediciones después de la última publicación
+    mutable GrafoCSR grafoCSR;        // Copia de la versión vigente que usan los cálculos propios
+    mutable uint64_t numeroGrafo = 0; // Número de la versión copiada en grafoCSR
+    EspacioBidireccional espacioRuta; // Memoria de trabajo de las consultas punto a punto
+    std::unique_ptr<SimuladorVectorDistancia> vectorDistancia; // Simulación activa (si se inició)
+    InformeVD ultimoInformeVD;        // Reconvergencia tras la última edición de un enlace
+    std::unique_ptr<SimuladorEstadoEnlace> estadoEnlace; // Simulación de estado de enlace (si se activó)
+    InformeLS ultimoInformeLS;        // Inundación tras la última edición
+    std::unique_ptr<TablaReenvio> fib; // FIB de todos los enrutadores; se rehace si cambió la instantánea
+    std::unique_ptr<JerarquiaContraccion> jerarquia; // Atajos para consultas punto a punto (si se preparó)
+    EspacioJerarquia espacioJerarquia;
+
+    void reemplazarDesdeCSR(GrafoCSR nuevo);
+    void vaciar();
+    int ranuraDe(int id) const;       // -1 si el id no existe
+    int ocuparRanura(int id);         // una libre o una nueva al final
+    void liberarRanura(int ranura);   // quita sus enlaces de ambos lados
+
+    // Adyacencia por ranuras, en la disposición que esté en uso
+    int costoEntre(int ranura1, int ranura2) const; // INFINITO si no hay enlace
+    void fijarEnlace(int ranura1, int ranura2, int costo);
+    void quitarEnlace(int ranura1, int ranura2);
+    void vecinosDe(int ranura, std::vector<Vecino>& vecinos) const;
+    void ajustarAlmacenamiento();     // lista o matriz según la densidad
+    void pasarADensa(int ancho);
+    void pasarADispersa();
+    void enlaceCambiado(int id1, int id2, int costoAnterior, int costoNuevo);
+    void mostrarInformeVD(const InformeVD& informe) const;
+    void enlaceCambiadoVD(int indice1, int indice2);
+    void mostrarInformeLS(const InformeLS& informe) const;
+    void topologiaCambiadaLS(const std::vector<int>& origenes);
+    bool jerarquiaVigente() const;
+    void guardarJerarquia(const std::string& rutaTopologia) const;
+    void cargarJerarquia(const std::string& rutaTopologia);
 
 public:
     // ===========================
@@ -23,17 +117,41 @@ public:
     Red(int cantidad);            // Constructor con número de enrutadores
     ~Red();                       // Destructor (libera memoria)
 
+    void setHilos(int cantidad);  // Hilos de cómputo (0 = núcleos disponibles)
+    PoolHilos& obtenerPool() const;        // Pool compartido por todos los cálculos paralelos
+    const GrafoCSR& instantanea() const;   // Vista CSR inmutable del estado actual (solo el hilo que edita)
+    VersionFijada fijarVersion() const;    // Versión vigente, fijada; se puede pedir desde cualquier hilo
+    bool adyacenciaDensa() const { return densa; }     // Enlaces en la matriz de costos (si no, en listas)
+    ReferenciaEnrutador referencia(int id) const; // ranura -1 si el id no existe
+    int idDe(ReferenciaEnrutador referencia) const; // 0 si el enrutador ya se eliminó
+
     // ===========================
     // Funciones principales
     // ===========================
-    void generarRedAleatoria();   // Genera una red con enlaces aleatorios
+    void generarRedAleatoria(uint64_t semilla = 0);            // Red completa con costos aleatorios (0 = semilla del reloj)
+    bool generarTopologia(const ParametrosTopologia& parametros); // Reemplaza la red por una topología sintética
     void mostrarRed() const;      // Muestra la matriz de costos mínimos entre todos los enrutadores
 
-    void guardarEnArchivo(const std::string& nombreArchivo) const; // Guarda la red en un archivo
-    void cargarDesdeArchivo(const std::string& nombreArchivo);     // Carga la red desde un archivo
+    // Devuelven false (y lo informan por cerr) si no se pudo guardar o cargar;
+    // una carga fallida deja la red como estaba
+    bool guardarEnArchivo(const std::string& nombreArchivo) const; // Guarda la red en un archivo
+    bool cargarDesdeArchivo(const std::string& nombreArchivo);     // Carga la red desde un archivo
+    bool guardarBinario(const std::string& nombreArchivo) const;   // Guarda la instantánea CSR en binario
+    bool cargarBinario(const std::string& nombreArchivo);          // Carga un binario mapeándolo en memoria
+    bool exportarRutas(const std::string& nombreArchivo, FormatoExportacion formato,
+                       ContenidoExportacion contenido) const; // Matriz o tablas en CSV o binario, fila por fila
 
     void calcularRutaMasCorta(int origen, int destino);            // Aplica Dijkstra entre dos enrutadores
-    void mostrarTablasDeEnrutamiento();                            // Muestra la tabla de enrutamiento de cada enrutador
+    bool prepararJerarquia();     // Jerarquía de contracción para calcularRutaMasCorta (se guarda junto a la red)
+    void mostrarTablasDeEnrutamiento(const std::vector<int>& ids = {}); // Tablas de los enrutadores indicados (todos si está vacío)
+
+    // ===========================
+    // Simulación de protocolos
+    // ===========================
+    void simularVectorDistancia(const ConfiguracionVD& configuracion); // Converge desde cero e informa
+    void mostrarTablasVectorDistancia() const;                         // Tablas de cada enrutador según la simulación
+    void simularEstadoEnlace(const ConfiguracionLS& configuracion);    // Las ediciones siguientes se inundan como LSA
+    void simularTrafico(const ConfiguracionTrafico& configuracion);    // Reenvía paquetes sintéticos con las FIB
 
     // ===========================
     // Gestión de enrutadores
@@ -46,6 +164,20 @@ public:
     // ===========================
     void agregarEnlace();          // Agrega un enlace entre dos enrutadores
     void eliminarEnlace();         // Elimina un enlace entre dos enrutadores
+
+    // ===========================
+    // Ediciones sin interacción (no leen de cin ni escriben en cout)
+    // ===========================
+    int crearEnrutador();                        // Devuelve el id del nuevo enrutador
+    bool quitarEnrutador(int id);                // false si el id no existe
+    bool conectar(int id1, int id2, int costo);  // Crea el enlace o cambia su costo (false si es negativo)
+    bool desconectar(int id1, int id2);          // false si los ids no son válidos
+
+    // Todas las ediciones o ninguna: se validan juntas en orden, se aplican
+    // en una pasada sobre las listas de vecinos (si un enlace se edita varias
+    // veces vale la última) y la caché de rutas y las simulaciones se
+    // actualizan una sola vez por lote
+    ResultadoEdiciones aplicarEdiciones(const std::vector<Edicion>& ediciones);
 };
 
 #endif // RED_H
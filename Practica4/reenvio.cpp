@@ -0,0 +1,222 @@
+#include "reenvio.h"
+#include "generadores.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+using namespace std;
+
+// Destinos por tarea al armar la FIB: cada tarea escribe un tramo contiguo
+// de cada fila, sin compartir líneas de caché con otras tareas
+static const int DESTINOS_POR_TAREA = 64;
+
+// Paquetes por lote del simulador de tráfico
+static const int PAQUETES_POR_LOTE = 4096;
+
+#if defined(__GNUC__)
+#define PRECARGAR(direccion) __builtin_prefetch(direccion)
+#else
+#define PRECARGAR(direccion) ((void)0)
+#endif
+
+// ============================
+// Construcción de la FIB
+// ============================
+bool TablaReenvio::construir(const GrafoCSR& grafo, PoolHilos& pool) {
+    auto t0 = chrono::steady_clock::now();
+    g = grafo;
+    n = g.cantidadNodos();
+    fib8.clear();
+    fib16.clear();
+
+    int gradoMaximo = 0;
+    for (int i = 0; i < n; ++i) gradoMaximo = max(gradoMaximo, g.inicio[i + 1] - g.inicio[i]);
+    // El valor máximo de cada tipo queda reservado para "sin ruta"
+    if (gradoMaximo < UINT8_MAX) ancho = 1;
+    else if (gradoMaximo < UINT16_MAX) ancho = 2;
+    else return false;
+    if ((double)n * n * ancho > (double)MAX_BYTES_FIB) return false;
+
+    if (ancho == 1) llenar(fib8, pool);
+    else llenar(fib16, pool);
+
+    ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return true;
+}
+
+template <typename T>
+void TablaReenvio::llenar(vector<T>& fib, PoolHilos& pool) {
+    const T SIN_RUTA = numeric_limits<T>::max();
+    fib.assign((size_t)n * n, SIN_RUTA);
+
+    struct Espacio {
+        vector<int> dist, prev;   // prev: un arreglo de n por destino del bloque
+        EspacioDijkstra dijkstra;
+    };
+    vector<Espacio> espacios(pool.cantidadHilos());
+    for (auto& e : espacios) {
+        e.dist.resize(n);
+        e.prev.resize((size_t)DESTINOS_POR_TAREA * n);
+    }
+
+    int tareas = (n + DESTINOS_POR_TAREA - 1) / DESTINOS_POR_TAREA;
+    pool.paraCada(tareas, [&](int t, int hilo) {
+        Espacio& esp = espacios[hilo];
+        int primero = t * DESTINOS_POR_TAREA;
+        int cuantos = min(DESTINOS_POR_TAREA, n - primero);
+        for (int j = 0; j < cuantos; ++j)
+            dijkstra(g, primero + j, esp.dist.data(), esp.prev.data() + (size_t)j * n, esp.dijkstra);
+
+        // Transposición por mosaicos: los árboles dan una columna de la FIB
+        // por destino y cada fila es de un enrutador
+        for (int r0 = 0; r0 < n; r0 += DESTINOS_POR_TAREA) {
+            int r1 = min(n, r0 + DESTINOS_POR_TAREA);
+            for (int j = 0; j < cuantos; ++j) {
+                const int* prev = esp.prev.data() + (size_t)j * n;
+                for (int r = r0; r < r1; ++r) {
+                    int salto = prev[r];
+                    if (salto < 0) continue; // el propio destino o inalcanzable
+                    // Las listas de vecinos están ordenadas por índice. Si el
+                    // predecesor no es vecino de r (un enlace de un solo
+                    // sentido) no hay puerto: queda SIN_RUTA
+                    const int* vecinos = g.destino.begin() + g.inicio[r];
+                    const int* finVecinos = g.destino.begin() + g.inicio[r + 1];
+                    const int* it = lower_bound(vecinos, finVecinos, salto);
+                    if (it != finVecinos && *it == salto)
+                        fib[(size_t)r * n + primero + j] = (T)(it - vecinos);
+                }
+            }
+        }
+    });
+}
+
+int TablaReenvio::puerto(int enrutador, int destino) const {
+    size_t celda = (size_t)enrutador * n + destino;
+    int p = ancho == 1 ? fib8[celda] : fib16[celda];
+    int sinRuta = ancho == 1 ? UINT8_MAX : UINT16_MAX;
+    return p == sinRuta ? -1 : p;
+}
+
+int TablaReenvio::siguienteSalto(int enrutador, int destino) const {
+    int p = puerto(enrutador, destino);
+    return p < 0 ? -1 : g.destino[g.inicio[enrutador] + p];
+}
+
+// ============================
+// Reenvío por lotes
+// ============================
+namespace {
+
+struct alignas(64) EstadoHilo {
+    vector<int> actual, destino, costo;   // paquetes vivos del lote
+    vector<long long> histograma;
+    long long entregados = 0, sinRuta = 0, bucles = 0, saltos = 0, costoTotal = 0;
+};
+
+template <typename T>
+void reenviarLote(const GrafoCSR& g, const T* fib, int n, int ttl, EstadoHilo& h,
+                  Aleatorio& rng, int cantidad) {
+    const T SIN_RUTA = numeric_limits<T>::max();
+    int* actual = h.actual.data();
+    int* destino = h.destino.data();
+    int* costo = h.costo.data();
+
+    int vivos = 0;
+    for (int i = 0; i < cantidad; ++i) {
+        int o = (int)(rng.siguiente() % n);
+        int d = (int)(rng.siguiente() % n);
+        if (o == d) {
+            ++h.entregados;
+            ++h.histograma[0];
+            continue;
+        }
+        PRECARGAR(fib + (size_t)o * n + d);
+        actual[vivos] = o;
+        destino[vivos] = d;
+        costo[vivos] = 0;
+        ++vivos;
+    }
+
+    // Un salto por paquete en cada paso; los que siguen se compactan al frente
+    for (int paso = 1; vivos > 0; ++paso) {
+        int quedan = 0;
+        for (int i = 0; i < vivos; ++i) {
+            int r = actual[i], d = destino[i];
+            T p = fib[(size_t)r * n + d];
+            if (p == SIN_RUTA) {
+                ++h.sinRuta;
+                continue;
+            }
+            int e = g.inicio[r] + p;
+            int v = g.destino[e];
+            int c = costo[i] + g.costo[e];
+            if (v == d) {
+                ++h.entregados;
+                h.saltos += paso;
+                h.costoTotal += c;
+                ++h.histograma[paso];
+                continue;
+            }
+            if (paso >= ttl) {
+                ++h.bucles;
+                continue;
+            }
+            // La entrada del próximo salto se lee recién en el paso siguiente:
+            // se pide ya para que la espera se solape con el resto del lote
+            PRECARGAR(fib + (size_t)v * n + d);
+            actual[quedan] = v;
+            destino[quedan] = d;
+            costo[quedan] = c;
+            ++quedan;
+        }
+        vivos = quedan;
+    }
+}
+
+} // namespace
+
+InformeTrafico simularTrafico(const TablaReenvio& fib, const ConfiguracionTrafico& config, PoolHilos& pool) {
+    InformeTrafico informe;
+    int n = fib.cantidadNodos();
+    if (n == 0 || config.paquetes <= 0) return informe;
+    auto t0 = chrono::steady_clock::now();
+
+    int ttl = config.ttl > 0 ? config.ttl : n;
+    vector<EstadoHilo> estados(pool.cantidadHilos());
+    for (auto& h : estados) {
+        h.actual.resize(PAQUETES_POR_LOTE);
+        h.destino.resize(PAQUETES_POR_LOTE);
+        h.costo.resize(PAQUETES_POR_LOTE);
+        h.histograma.assign(ttl + 1, 0);
+    }
+
+    long long lotes = (config.paquetes + PAQUETES_POR_LOTE - 1) / PAQUETES_POR_LOTE;
+    // paraCada recibe un int: los lotes se recorren en tramos
+    const long long TRAMO = INT32_MAX;
+    for (long long base = 0; base < lotes; base += TRAMO) {
+        int cuantos = (int)min(TRAMO, lotes - base);
+        pool.paraCada(cuantos, [&](int k, int hilo) {
+            long long lote = base + k;
+            int cantidad = (int)min<long long>(PAQUETES_POR_LOTE, config.paquetes - lote * PAQUETES_POR_LOTE);
+            Aleatorio rng(config.semilla, (uint64_t)lote); // no depende del reparto entre hilos
+            if (fib.anchoEntrada() == 1)
+                reenviarLote(fib.grafo(), fib.entradas8(), n, ttl, estados[hilo], rng, cantidad);
+            else
+                reenviarLote(fib.grafo(), fib.entradas16(), n, ttl, estados[hilo], rng, cantidad);
+        }, 4);
+    }
+
+    informe.paquetes = config.paquetes;
+    informe.histograma.assign(ttl + 1, 0);
+    for (const auto& h : estados) {
+        informe.entregados += h.entregados;
+        informe.sinRuta += h.sinRuta;
+        informe.bucles += h.bucles;
+        informe.saltos += h.saltos;
+        informe.costo += h.costoTotal;
+        for (int s = 0; s <= ttl; ++s) informe.histograma[s] += h.histograma[s];
+    }
+    while (informe.histograma.size() > 1 && informe.histograma.back() == 0) informe.histograma.pop_back();
+
+    informe.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return informe;
+}
@@ -0,0 +1,85 @@
+#ifndef REENVIO_H
+#define REENVIO_H
+
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+// ===========================
+// Plano de datos: tablas de reenvío (FIB) compactas
+// ===========================
+// La FIB de cada enrutador es un arreglo denso indexado por el índice del
+// destino. Cada entrada guarda el puerto de salida (la posición del
+// siguiente salto dentro de la lista de vecinos del enrutador), no su
+// índice, así que con grado menor que 255 cabe en un byte y con grado
+// menor que 65535, en dos. Todas las filas están en un solo bloque de
+// n x n entradas.
+//
+// El siguiente salto de r hacia d es el predecesor de r en el árbol de
+// rutas más cortas con raíz en d (los enlaces son simétricos), así que
+// los paquetes hacia d siguen siempre el mismo árbol y no forman bucles.
+// Si en algún caso el predecesor no está entre los vecinos de r, la celda
+// queda sin ruta en lugar de apuntar a un puerto que no existe.
+
+// Tope de memoria de la FIB completa
+const size_t MAX_BYTES_FIB = (size_t)1 << 30;
+
+class TablaReenvio {
+public:
+    // Un árbol por destino, repartidos en el pool. false si la red tiene un
+    // enrutador con demasiados vecinos o la FIB no cabe en MAX_BYTES_FIB
+    bool construir(const GrafoCSR& grafo, PoolHilos& pool);
+
+    const GrafoCSR& grafo() const { return g; }
+    int cantidadNodos() const { return n; }
+    int anchoEntrada() const { return ancho; }   // bytes por entrada: 1 o 2
+    size_t bytes() const { return (size_t)n * n * ancho; }
+    double msConstruccion() const { return ms; }
+
+    int puerto(int enrutador, int destino) const;         // -1 si no hay ruta
+    int siguienteSalto(int enrutador, int destino) const; // -1 si no hay ruta
+
+    const uint8_t* entradas8() const { return fib8.data(); }
+    const uint16_t* entradas16() const { return fib16.data(); }
+
+private:
+    template <typename T> void llenar(std::vector<T>& fib, PoolHilos& pool);
+
+    GrafoCSR g;
+    int n = 0;
+    int ancho = 0;
+    double ms = 0;
+    std::vector<uint8_t> fib8;     // se usa una de las dos según 'ancho'
+    std::vector<uint16_t> fib16;
+};
+
+// ===========================
+// Tráfico sintético
+// ===========================
+// Los paquetes (origen y destino uniformes, reproducibles con la semilla)
+// avanzan en lotes: en cada paso todos los paquetes vivos del lote dan un
+// salto, y los que llegan, no tienen ruta o agotan el TTL salen del lote.
+// Cada hilo reutiliza sus arreglos, así que el ciclo de reenvío no pide
+// memoria.
+struct ConfiguracionTrafico {
+    long long paquetes = 1000000;
+    int ttl = 0;                  // 0 = cantidad de enrutadores (ningún camino simple es más largo)
+    uint64_t semilla = 1;
+};
+
+struct InformeTrafico {
+    long long paquetes = 0;
+    long long entregados = 0;
+    long long sinRuta = 0;
+    long long bucles = 0;                  // descartados por TTL
+    long long saltos = 0;                  // de los entregados
+    long long costo = 0;                   // suma de costos recorridos por los entregados
+    std::vector<long long> histograma;     // entregados por cantidad de saltos
+    double ms = 0;
+};
+
+InformeTrafico simularTrafico(const TablaReenvio& fib, const ConfiguracionTrafico& config, PoolHilos& pool);
+
+#endif // REENVIO_H
@@ -0,0 +1,578 @@
+#include "servidor.h"
+#include "exportacion.h"
+#include "bidireccional.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#define SERVIDOR_EPOLL 1
+#endif
+using namespace std;
+
+#ifdef SERVIDOR_EPOLL
+
+namespace {
+
+const size_t MAX_ENTRADA = 1 << 20;   // bytes recibidos sin procesar antes de dejar de leer
+const size_t MAX_SALIDA = 4 << 20;    // bytes sin enviar antes de dejar de despachar lotes
+const size_t MAX_LOTE = 256;          // solicitudes por tarea de un trabajador
+const int FRAGMENTOS_CACHE = 16;
+
+// Identificadores de epoll; las conexiones se numeran desde PRIMERA_CONEXION
+// (no se usa el descriptor, que el sistema reutiliza al cerrar)
+const uint64_t ID_ESCUCHA = 0, ID_AVISOS = 1, ID_SENALES = 2, PRIMERA_CONEXION = 3;
+
+// ============================
+// Caché de árboles por origen
+// ============================
+struct Arbol {
+    vector<int> dist, prev, salto;
+    size_t bytes() const { return 12 * dist.size() + sizeof(Arbol); }
+};
+
+struct EspacioTrabajador {
+    EspacioDijkstra dijkstra;
+    EspacioBidireccional bidireccional;
+    vector<int> pila, camino;
+};
+
+class CacheArboles {
+public:
+    explicit CacheArboles(size_t memoria) : memoriaFragmento(max<size_t>(1, memoria / FRAGMENTOS_CACHE)) {}
+
+    // Árbol de 'origen' en 'version'. Si no está y 'siempre' es false, solo
+    // se calcula cuando el origen ya se pidió antes: un origen que aparece
+    // una vez no desplaza árboles útiles y el llamador resuelve esa consulta
+    // con una búsqueda bidireccional (devuelve nullptr)
+    shared_ptr<const Arbol> obtener(const VersionRed& version, int origen, EspacioTrabajador& e, bool siempre) {
+        uint64_t clave = version.numero << 32 | (uint32_t)origen;
+        Fragmento& f = fragmentos[(clave * 0x9E3779B97F4A7C15ull) >> 60];
+        {
+            lock_guard<mutex> candado(f.m);
+            auto it = f.indice.find(clave);
+            if (it != f.indice.end()) {
+                f.lru.splice(f.lru.begin(), f.lru, it->second);
+                ++aciertos;
+                return it->second->second;
+            }
+            if (!siempre && f.vistos.insert(clave).second) {
+                // Se olvidan los candidatos de a tandas para acotar la memoria
+                if (f.vistos.size() > limiteVistos(version)) f.vistos.clear();
+                ++directas;
+                return nullptr;
+            }
+        }
+
+        // Fuera del candado: dos trabajadores pueden calcular el mismo árbol
+        // a la vez, pero ninguno frena a los demás fragmentos ni consultas
+        ++fallos;
+        const GrafoCSR& g = version.grafo;
+        int n = g.cantidadNodos();
+        auto arbol = make_shared<Arbol>();
+        arbol->dist.resize(n);
+        arbol->prev.resize(n);
+        arbol->salto.resize(n);
+        dijkstra(g, origen, arbol->dist.data(), arbol->prev.data(), e.dijkstra);
+        siguientesSaltos(arbol->prev.data(), origen, n, arbol->salto.data(), e.pila);
+
+        lock_guard<mutex> candado(f.m);
+        auto it = f.indice.find(clave);
+        if (it != f.indice.end()) return it->second->second;
+        f.lru.emplace_front(clave, arbol);
+        f.indice[clave] = f.lru.begin();
+        f.bytes += arbol->bytes();
+        while (f.bytes > memoriaFragmento && f.lru.size() > 1) {
+            f.bytes -= f.lru.back().second->bytes();
+            f.indice.erase(f.lru.back().first);
+            f.lru.pop_back();
+        }
+        return arbol;
+    }
+
+    atomic<long long> aciertos{0}, fallos{0}, directas{0};
+
+private:
+    struct Fragmento {
+        mutex m;
+        list<pair<uint64_t, shared_ptr<const Arbol>>> lru;   // el más reciente al frente
+        unordered_map<uint64_t, list<pair<uint64_t, shared_ptr<const Arbol>>>::iterator> indice;
+        unordered_set<uint64_t> vistos;   // orígenes pedidos una vez, aún sin árbol
+        size_t bytes = 0;
+    };
+
+    // Unas cuantas veces los árboles que caben en un fragmento
+    size_t limiteVistos(const VersionRed& version) const {
+        size_t porArbol = 12 * (size_t)version.grafo.cantidadNodos() + sizeof(Arbol);
+        return max<size_t>(64, 4 * memoriaFragmento / porArbol);
+    }
+
+    size_t memoriaFragmento;
+    Fragmento fragmentos[FRAGMENTOS_CACHE];
+};
+
+// ============================
+// Conexiones
+// ============================
+struct Conexion {
+    uint64_t id = 0;
+    int fd = -1;
+    string entrada;               // bytes recibidos; los procesados están antes de 'consumida'
+    size_t consumida = 0;
+    string salida;                // respuestas por enviar desde 'enviada'
+    size_t enviada = 0;
+    uint32_t interes = 0;         // eventos registrados en epoll
+    bool finEntrada = false;      // el cliente ya no manda más (shutdown o fin de archivo)
+
+    // Mientras enVuelo, 'lote' y 'respuestas' son del trabajador
+    bool enVuelo = false;
+    bool cerrada = false;
+    vector<SolicitudRuta> lote;
+    string respuestas;
+};
+
+void agregar(string& destino, const void* datos, size_t bytes) {
+    destino.append((const char*)datos, bytes);
+}
+
+void responder(const VersionRed& version, CacheArboles& cache, const SolicitudRuta& s,
+               EspacioTrabajador& e, string& salida) {
+    RespuestaRuta r{s.id, RESPUESTA_OK, s.tipo, -1, 0};
+    const GrafoCSR& g = version.grafo;
+
+    if (s.tipo == SOLICITUD_INFO) {
+        uint32_t datos[3] = {(uint32_t)g.cantidadNodos(), (uint32_t)version.numero,
+                             g.cantidadNodos() > 0 ? (uint32_t)g.ids[g.cantidadNodos() - 1] : 0u};
+        r.costo = 0;
+        r.cantidad = 3;
+        agregar(salida, &r, sizeof r);
+        agregar(salida, datos, sizeof datos);
+        return;
+    }
+    if (s.tipo != SOLICITUD_COSTO && s.tipo != SOLICITUD_RUTA && s.tipo != SOLICITUD_TABLA) {
+        r.estado = RESPUESTA_TIPO_INVALIDO;
+        agregar(salida, &r, sizeof r);
+        return;
+    }
+    int o = version.indiceDe(s.origen);
+    int d = s.tipo == SOLICITUD_TABLA ? o : version.indiceDe(s.destino);
+    if (o < 0 || d < 0) {
+        r.estado = RESPUESTA_ID_INVALIDO;
+        agregar(salida, &r, sizeof r);
+        return;
+    }
+
+    shared_ptr<const Arbol> arbol = cache.obtener(version, o, e, s.tipo == SOLICITUD_TABLA);
+    if (!arbol) {
+        int costo = rutaBidireccional(g, o, d, e.camino, e.bidireccional);
+        if (costo == INFINITO) {
+            r.estado = RESPUESTA_SIN_RUTA;
+            agregar(salida, &r, sizeof r);
+            return;
+        }
+        r.costo = costo;
+        if (s.tipo == SOLICITUD_RUTA) {
+            for (int& x : e.camino) x = g.ids[x];
+            r.cantidad = (uint32_t)e.camino.size();
+        }
+        agregar(salida, &r, sizeof r);
+        if (s.tipo == SOLICITUD_RUTA) agregar(salida, e.camino.data(), e.camino.size() * sizeof(int));
+        return;
+    }
+    const int* dist = arbol->dist.data();
+
+    if (s.tipo == SOLICITUD_TABLA) {
+        r.costo = 0;
+        size_t cabecera = salida.size();
+        agregar(salida, &r, sizeof r);
+        uint32_t cantidad = 0;
+        for (int x = 0; x < g.cantidadNodos(); ++x) {
+            if (x == o || dist[x] == INFINITO) continue;
+            int32_t terna[3] = {g.ids[x], dist[x], g.ids[arbol->salto[x]]};
+            agregar(salida, terna, sizeof terna);
+            cantidad += 3;
+        }
+        memcpy(&salida[cabecera] + offsetof(RespuestaRuta, cantidad), &cantidad, sizeof cantidad);
+        return;
+    }
+
+    if (dist[d] == INFINITO) {
+        r.estado = RESPUESTA_SIN_RUTA;
+        agregar(salida, &r, sizeof r);
+        return;
+    }
+    r.costo = dist[d];
+    if (s.tipo == SOLICITUD_COSTO) {
+        agregar(salida, &r, sizeof r);
+        return;
+    }
+
+    e.camino.clear();
+    for (int x = d; x != o; x = arbol->prev[x]) e.camino.push_back(g.ids[x]);
+    e.camino.push_back(g.ids[o]);
+    reverse(e.camino.begin(), e.camino.end());
+    r.cantidad = (uint32_t)e.camino.size();
+    agregar(salida, &r, sizeof r);
+    agregar(salida, e.camino.data(), e.camino.size() * sizeof(int));
+}
+
+// ============================
+// Trabajadores
+// ============================
+// Cola de conexiones con un lote listo y lista de las ya resueltas; el
+// bucle se entera de estas por el eventfd
+struct Despacho {
+    mutex m;
+    condition_variable hayTrabajo;
+    deque<Conexion*> pendientes;
+    bool terminar = false;
+
+    mutex mListas;
+    vector<Conexion*> listas;
+    int avisos = -1;
+};
+
+void trabajador(Red& red, CacheArboles& cache, Despacho& despacho) {
+    EspacioTrabajador espacio;
+    while (true) {
+        Conexion* c;
+        {
+            unique_lock<mutex> candado(despacho.m);
+            despacho.hayTrabajo.wait(candado, [&] { return despacho.terminar || !despacho.pendientes.empty(); });
+            if (despacho.terminar) return;
+            c = despacho.pendientes.front();
+            despacho.pendientes.pop_front();
+        }
+
+        // Todo el lote se responde sobre la misma versión
+        VersionFijada version = red.fijarVersion();
+        c->respuestas.clear();
+        for (const SolicitudRuta& s : c->lote) responder(*version, cache, s, espacio, c->respuestas);
+
+        {
+            lock_guard<mutex> candado(despacho.mListas);
+            despacho.listas.push_back(c);
+        }
+        uint64_t uno = 1;
+        if (write(despacho.avisos, &uno, sizeof uno) < 0) { /* el contador ya tiene un aviso pendiente */ }
+    }
+}
+
+// ============================
+// Bucle de eventos
+// ============================
+class BucleServidor {
+public:
+    BucleServidor(int epoll, Despacho& despacho) : ep(epoll), despacho(despacho) {}
+
+    void aceptar(int escucha) {
+        while (true) {
+            int fd = accept4(escucha, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN o error transitorio: se reintenta con el próximo evento
+            auto c = make_unique<Conexion>();
+            c->id = siguienteId++;
+            c->fd = fd;
+            c->interes = EPOLLIN;
+            epoll_event ev{};
+            ev.events = c->interes;
+            ev.data.u64 = c->id;
+            epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+            conexiones[c->id] = move(c);
+            ++aceptadas;
+        }
+    }
+
+    void evento(uint64_t id, uint32_t eventos) {
+        auto it = conexiones.find(id);
+        if (it == conexiones.end()) return;
+        Conexion& c = *it->second;
+        if (c.cerrada) return;
+        // EPOLLHUP llega cuando el cliente cerró las dos mitades: ya no
+        // puede leer respuestas. Si solo cerró la escritura, leer() lo nota
+        if (eventos & (EPOLLERR | EPOLLHUP)) {
+            cerrar(c);
+            return;
+        }
+        if ((eventos & EPOLLIN) && !leer(c)) {
+            cerrar(c);
+            return;
+        }
+        if ((eventos & EPOLLOUT) && !enviar(c)) {
+            cerrar(c);
+            return;
+        }
+        despachar(c);
+        if (terminada(c)) {
+            cerrar(c);
+            return;
+        }
+        actualizarInteres(c);
+    }
+
+    // Los trabajadores terminaron estos lotes
+    void recibirListas() {
+        uint64_t cuenta;
+        if (read(despacho.avisos, &cuenta, sizeof cuenta) < 0) return;
+        vector<Conexion*> listas;
+        {
+            lock_guard<mutex> candado(despacho.mListas);
+            listas.swap(despacho.listas);
+        }
+        for (Conexion* c : listas) {
+            c->enVuelo = false;
+            solicitudes += c->lote.size();
+            if (c->cerrada) {
+                conexiones.erase(c->id);
+                continue;
+            }
+            c->salida.append(c->respuestas);
+            if (!enviar(*c)) {
+                cerrar(*c);
+                continue;
+            }
+            despachar(*c);
+            if (terminada(*c)) {
+                cerrar(*c);
+                continue;
+            }
+            actualizarInteres(*c);
+        }
+    }
+
+    void cerrarTodas() {
+        for (auto& [id, c] : conexiones)
+            if (c->fd >= 0) close(c->fd);
+        conexiones.clear();
+    }
+
+    long long aceptadas = 0, solicitudes = 0;
+
+private:
+    // false si hubo un error. Si el cliente cerró su mitad de escritura se
+    // deja de leer, pero la conexión sigue hasta responder lo que mandó
+    bool leer(Conexion& c) {
+        char bufer[1 << 16];
+        while (c.entrada.size() - c.consumida < MAX_ENTRADA) {
+            ssize_t leidos = read(c.fd, bufer, sizeof bufer);
+            if (leidos > 0) {
+                c.entrada.append(bufer, leidos);
+                continue;
+            }
+            if (leidos == 0) {
+                c.finEntrada = true;
+                return true;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        return true;
+    }
+
+    bool enviar(Conexion& c) {
+        while (c.enviada < c.salida.size()) {
+            ssize_t escritos = send(c.fd, c.salida.data() + c.enviada, c.salida.size() - c.enviada, MSG_NOSIGNAL);
+            if (escritos > 0) {
+                c.enviada += escritos;
+                continue;
+            }
+            if (escritos < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) break;
+            return false;
+        }
+        if (c.enviada == c.salida.size()) {
+            c.salida.clear();
+            c.enviada = 0;
+        }
+        return true;
+    }
+
+    // Pasa a un trabajador las solicitudes completas, si la conexión no
+    // tiene ya un lote en proceso ni demasiadas respuestas sin enviar
+    void despachar(Conexion& c) {
+        if (c.enVuelo || c.cerrada || c.salida.size() - c.enviada > MAX_SALIDA) return;
+        size_t completas = (c.entrada.size() - c.consumida) / sizeof(SolicitudRuta);
+        if (completas == 0) return;
+        completas = min(completas, MAX_LOTE);
+
+        c.lote.resize(completas);
+        memcpy(c.lote.data(), c.entrada.data() + c.consumida, completas * sizeof(SolicitudRuta));
+        c.consumida += completas * sizeof(SolicitudRuta);
+        if (c.consumida * 2 >= c.entrada.size()) {
+            c.entrada.erase(0, c.consumida);
+            c.consumida = 0;
+        }
+
+        c.enVuelo = true;
+        {
+            lock_guard<mutex> candado(despacho.m);
+            despacho.pendientes.push_back(&c);
+        }
+        despacho.hayTrabajo.notify_one();
+    }
+
+    // Sin más entrada, sin lote en proceso, sin solicitudes completas por
+    // despachar y con todo enviado (una solicitud cortada al final se descarta)
+    bool terminada(const Conexion& c) const {
+        return c.finEntrada && !c.enVuelo && c.enviada == c.salida.size() &&
+               c.entrada.size() - c.consumida < sizeof(SolicitudRuta);
+    }
+
+    void actualizarInteres(Conexion& c) {
+        if (c.cerrada) return;
+        uint32_t interes = 0;
+        if (!c.finEntrada && c.entrada.size() - c.consumida < MAX_ENTRADA) interes |= EPOLLIN;
+        if (c.enviada < c.salida.size()) interes |= EPOLLOUT;
+        if (interes == c.interes) return;
+        c.interes = interes;
+        epoll_event ev{};
+        ev.events = interes;
+        ev.data.u64 = c.id;
+        epoll_ctl(ep, EPOLL_CTL_MOD, c.fd, &ev);
+    }
+
+    // Con un lote en proceso la conexión se libera cuando vuelve del trabajador
+    void cerrar(Conexion& c) {
+        epoll_ctl(ep, EPOLL_CTL_DEL, c.fd, nullptr);
+        close(c.fd);
+        c.fd = -1;
+        c.cerrada = true;
+        if (!c.enVuelo) conexiones.erase(c.id);
+    }
+
+    int ep;
+    Despacho& despacho;
+    unordered_map<uint64_t, unique_ptr<Conexion>> conexiones;
+    uint64_t siguienteId = PRIMERA_CONEXION;
+};
+
+// SIGINT y SIGTERM se atienden con un manejador que solo escribe en un
+// eventfd (es seguro desde cualquier hilo, incluidos los del pool de la red)
+int fdTerminar = -1;
+
+void pedirTerminar(int) {
+    uint64_t uno = 1;
+    if (write(fdTerminar, &uno, sizeof uno) < 0) { /* ya hay un aviso pendiente */ }
+}
+
+void registrar(int ep, int fd, uint64_t id) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = id;
+    epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+}
+
+} // namespace
+
+int ejecutarServidor(Red& red, const ConfiguracionServidor& config) {
+    sockaddr_un direccion{};
+    direccion.sun_family = AF_UNIX;
+    if (config.socket.empty() || config.socket.size() >= sizeof(direccion.sun_path)) {
+        cerr << "Ruta de socket inválida: " << config.socket << endl;
+        return 1;
+    }
+    memcpy(direccion.sun_path, config.socket.c_str(), config.socket.size() + 1);
+
+    fdTerminar = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    struct sigaction accion{}, anteriorInt, anteriorTerm;
+    accion.sa_handler = pedirTerminar;
+    sigemptyset(&accion.sa_mask);
+    accion.sa_flags = SA_RESTART;
+    sigaction(SIGINT, &accion, &anteriorInt);
+    sigaction(SIGTERM, &accion, &anteriorTerm);
+    auto restaurarSenales = [&] {
+        sigaction(SIGINT, &anteriorInt, nullptr);
+        sigaction(SIGTERM, &anteriorTerm, nullptr);
+        close(fdTerminar);
+        fdTerminar = -1;
+    };
+
+    int escucha = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(config.socket.c_str()); // un socket viejo de una ejecución anterior
+    if (escucha < 0 || bind(escucha, (sockaddr*)&direccion, sizeof direccion) != 0 ||
+        listen(escucha, SOMAXCONN) != 0) {
+        cerr << "No se pudo escuchar en " << config.socket << ": " << strerror(errno) << endl;
+        if (escucha >= 0) close(escucha);
+        restaurarSenales();
+        return 1;
+    }
+
+    Despacho despacho;
+    despacho.avisos = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    registrar(ep, escucha, ID_ESCUCHA);
+    registrar(ep, despacho.avisos, ID_AVISOS);
+    registrar(ep, fdTerminar, ID_SENALES);
+
+    // La instantánea se arma antes de aceptar la primera conexión
+    VersionFijada version = red.fijarVersion();
+    CacheArboles cache(config.memoriaArboles);
+    int cantidad = config.trabajadores > 0 ? config.trabajadores : max(1u, thread::hardware_concurrency());
+    vector<thread> trabajadores;
+    for (int i = 0; i < cantidad; ++i)
+        trabajadores.emplace_back(trabajador, ref(red), ref(cache), ref(despacho));
+
+    cerr << "Servidor en " << config.socket << ": " << version->grafo.cantidadNodos()
+         << " enrutadores, " << cantidad << " trabajadores" << endl;
+
+    BucleServidor bucle(ep, despacho);
+    bool seguir = true;
+    epoll_event eventos[64];
+    while (seguir) {
+        int listos = epoll_wait(ep, eventos, 64, -1);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            cerr << "epoll_wait: " << strerror(errno) << endl;
+            break;
+        }
+        for (int i = 0; i < listos; ++i) {
+            uint64_t id = eventos[i].data.u64;
+            if (id == ID_ESCUCHA) bucle.aceptar(escucha);
+            else if (id == ID_AVISOS) bucle.recibirListas();
+            else if (id == ID_SENALES) seguir = false;
+            else bucle.evento(id, eventos[i].events);
+        }
+    }
+
+    {
+        lock_guard<mutex> candado(despacho.m);
+        despacho.terminar = true;
+    }
+    despacho.hayTrabajo.notify_all();
+    for (auto& t : trabajadores) t.join();
+    bucle.cerrarTodas();
+    close(escucha);
+    unlink(config.socket.c_str());
+    close(despacho.avisos);
+    close(ep);
+    restaurarSenales();
+
+    long long aciertos = cache.aciertos, fallos = cache.fallos, directas = cache.directas;
+    cerr << "Servidor detenido: " << bucle.aceptadas << " conexiones, " << bucle.solicitudes
+         << " solicitudes; árboles: " << aciertos << " aciertos, " << fallos << " calculados, "
+         << directas << " consultas resueltas sin árbol" << endl;
+    return 0;
+}
+
+#else
+
+int ejecutarServidor(Red&, const ConfiguracionServidor&) {
+    cerr << "El modo servidor necesita Linux (epoll y sockets Unix)." << endl;
+    return 1;
+}
+
+#endif
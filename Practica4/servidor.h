@@ -0,0 +1,38 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include "red.h"
+#include "protocolo.h"
+#include <string>
+#include <cstddef>
+
+// ===========================
+// Servidor de consultas de rutas (socket Unix)
+// ===========================
+// Un hilo atiende todas las conexiones con un bucle de epoll (sockets no
+// bloqueantes) y un grupo fijo de trabajadores resuelve las solicitudes.
+// Cada conexión tiene a lo sumo un lote en proceso: el bucle le pasa a un
+// trabajador las solicitudes completas que haya recibido, el trabajador
+// arma todas las respuestas sobre una versión fijada de la red y avisa por
+// un eventfd, y el bucle las envía. Así las respuestas de cada conexión
+// salen en orden y muchas conexiones se atienden en paralelo.
+//
+// Los árboles de rutas más cortas (distancias, predecesores y siguiente
+// salto) se guardan por origen en una caché LRU compartida, en fragmentos
+// con su propio mutex, hasta memoriaArboles bytes. La clave incluye el
+// número de versión de la red, así que un árbol nunca sirve a otra
+// topología. Un árbol se calcula recién la segunda vez que se pide su
+// origen (o siempre, para una tabla); las consultas de costo o ruta de un
+// origen nuevo se resuelven con una búsqueda bidireccional.
+//
+// Solo disponible en Linux. Termina con SIGINT o SIGTERM e informa por
+// cerr las solicitudes atendidas y los aciertos de la caché.
+struct ConfiguracionServidor {
+    std::string socket;                       // ruta del socket Unix
+    int trabajadores = 0;                     // 0 = núcleos disponibles
+    size_t memoriaArboles = (size_t)256 << 20;
+};
+
+int ejecutarServidor(Red& red, const ConfiguracionServidor& configuracion);
+
+#endif // SERVIDOR_H
@@ -0,0 +1,95 @@
+#include "todospares.h"
+#include "floydwarshall.h"
+#include "instrumentacion.h"
+#include <algorithm>
+using namespace std;
+
+// ============================
+// Matriz de predecesores
+// ============================
+void MatrizTodosLosPares::dimensionar(int nodos, bool predecesores) {
+    n = nodos;
+    dist.assign((size_t)n * n, INFINITO);
+    prev16.clear();
+    prev32.clear();
+    if (!predecesores) return;
+    if (angosta(n)) prev16.assign((size_t)n * n, sinPredecesor<uint16_t>());
+    else prev32.assign((size_t)n * n, sinPredecesor<int>());
+}
+
+void MatrizTodosLosPares::copiarFilaPrev(int i, int* destino) const {
+    if (prev16.empty()) {
+        copy(filaPrev<int>(i), filaPrev<int>(i) + n, destino);
+        return;
+    }
+    const uint16_t* fila = filaPrev<uint16_t>(i);
+    for (int j = 0; j < n; ++j) destino[j] = fila[j] == UINT16_MAX ? -1 : fila[j];
+}
+
+void MatrizTodosLosPares::asignarFilaPrev(int i, const int* origen) {
+    if (prev16.empty()) {
+        copy(origen, origen + n, filaPrev<int>(i));
+        return;
+    }
+    uint16_t* fila = filaPrev<uint16_t>(i);
+    for (int j = 0; j < n; ++j) fila[j] = (uint16_t)origen[j]; // -1 queda en 65535
+}
+
+void MatrizTodosLosPares::camino(int origen, int destino, vector<int>& c) const {
+    c.clear();
+    if (destino != origen && predecesor(origen, destino) == -1) return;
+    for (int cur = destino; cur != -1; cur = predecesor(origen, cur)) {
+        c.push_back(cur);
+        if (cur == origen) break;
+    }
+    reverse(c.begin(), c.end());
+}
+
+bool convieneFloydWarshall(const GrafoCSR& g) {
+    double n = g.cantidadNodos();
+    if (n < 2) return false;
+    double densidad = (double)g.destino.size() / (n * (n - 1));
+    if (densidad < UMBRAL_DENSIDAD_FLOYD) return false;
+    // El camino más caro posible debe quedar por debajo del infinito interno;
+    // si no, se usa Dijkstra (costos negativos tampoco: no son del dominio)
+    return g.costoMinimo >= 0 && (double)g.costoMaximo * (n - 1) < INF_FW;
+}
+
+void calcularTodosLosPares(const GrafoCSR& g, PoolHilos& pool,
+                           MatrizTodosLosPares& r, bool conPredecesores) {
+    MEDIR_FASE(FASE_TODOS_LOS_PARES);
+    int n = g.cantidadNodos();
+    r.n = n;
+
+    if (!conPredecesores && convieneFloydWarshall(g)) {
+        r.prev16.clear();
+        r.prev32.clear();
+        floydWarshallBloques(g, pool, r.dist);
+        return;
+    }
+
+    r.dimensionar(n, conPredecesores);
+
+    // Espacio de trabajo propio de cada hilo; con predecesores angostos
+    // Dijkstra escribe en una fila int que después se copia angostada
+    struct Espacio {
+        EspacioDijkstra dijkstra;
+        vector<int> prev;
+    };
+    vector<Espacio> espacios(pool.cantidadHilos());
+    bool angosta = !r.prev16.empty();
+
+    pool.paraCada(n, [&](int origen, int hilo) {
+        Espacio& e = espacios[hilo];
+        int* dist = r.filaDist(origen);
+        if (!conPredecesores) {
+            dijkstra(g, origen, dist, nullptr, e.dijkstra);
+        } else if (angosta) {
+            e.prev.resize(n);
+            dijkstra(g, origen, dist, e.prev.data(), e.dijkstra);
+            r.asignarFilaPrev(origen, e.prev.data());
+        } else {
+            dijkstra(g, origen, dist, r.filaPrev<int>(origen), e.dijkstra);
+        }
+    });
+}
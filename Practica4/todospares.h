@@ -0,0 +1,72 @@
+#ifndef TODOSPARES_H
+#define TODOSPARES_H
+
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+// ===========================
+// Costos mínimos entre todos los pares
+// ===========================
+// Matrices n x n en orden fila mayor: la fila i corresponde al origen i.
+// La matriz de predecesores es la tabla de enrutamiento: el camino de i a j
+// se reconstruye solo cuando se muestra, subiendo por los predecesores.
+// Con menos de 65535 nodos cada predecesor ocupa 2 bytes (65535 = ninguno);
+// si no, 4 (-1 = ninguno).
+struct MatrizTodosLosPares {
+    int n = 0;
+    std::vector<int> dist;        // dist[i*n + j], INFINITO si no hay ruta
+    std::vector<uint16_t> prev16; // prev[i*n + j] angosto; vacío si no se usa
+    std::vector<int> prev32;      // prev[i*n + j] ancho; vacío si no se usa
+
+    static bool angosta(int nodos) { return nodos < UINT16_MAX; }
+    bool conPredecesores() const { return !prev16.empty() || !prev32.empty(); }
+
+    // n x n con dist = INFINITO y, si se piden, predecesores en "ninguno"
+    void dimensionar(int nodos, bool predecesores);
+
+    const int* filaDist(int i) const { return dist.data() + (size_t)i * n; }
+    int* filaDist(int i) { return dist.data() + (size_t)i * n; }
+
+    // Fila de predecesores en el tipo P que corresponda (uint16_t o int)
+    template <typename P> P* filaPrev(int i) {
+        if constexpr (std::is_same_v<P, uint16_t>) return prev16.data() + (size_t)i * n;
+        else return prev32.data() + (size_t)i * n;
+    }
+    template <typename P> const P* filaPrev(int i) const {
+        if constexpr (std::is_same_v<P, uint16_t>) return prev16.data() + (size_t)i * n;
+        else return prev32.data() + (size_t)i * n;
+    }
+
+    int predecesor(int i, int j) const {               // -1 si no tiene
+        size_t k = (size_t)i * n + j;
+        if (!prev16.empty()) return prev16[k] == UINT16_MAX ? -1 : prev16[k];
+        return prev32[k];
+    }
+    void copiarFilaPrev(int i, int* destino) const;    // la fila como int, -1 = ninguno
+    void asignarFilaPrev(int i, const int* origen);
+
+    // Camino de 'origen' a 'destino' en 'camino' (vacío si no hay ruta);
+    // reutiliza la memoria del vector
+    void camino(int origen, int destino, std::vector<int>& camino) const;
+};
+
+// Valor "sin predecesor" de cada tipo de fila
+template <typename P> constexpr P sinPredecesor() { return (P)-1; }
+
+// Densidad (enlaces dirigidos / pares posibles) a partir de la cual la
+// matriz de distancias se calcula con Floyd–Warshall por bloques (si los
+// costos permiten sumar caminos sin llegar a su infinito interno)
+const double UMBRAL_DENSIDAD_FLOYD = 0.15;
+
+bool convieneFloydWarshall(const GrafoCSR& grafo);
+
+// Sin predecesores y con densidad alta se usa Floyd–Warshall por bloques;
+// en otro caso un Dijkstra por origen, repartiendo los orígenes entre los
+// hilos del pool (cada hilo usa su propio espacio de trabajo).
+void calcularTodosLosPares(const GrafoCSR& grafo, PoolHilos& pool,
+                           MatrizTodosLosPares& resultado, bool conPredecesores);
+
+#endif // TODOSPARES_H
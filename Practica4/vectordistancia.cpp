@@ -0,0 +1,222 @@
+#include "vectordistancia.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// Filas por tarea del pool en cada ronda
+static const int FILAS_POR_TAREA = 8;
+
+SimuladorVectorDistancia::SimuladorVectorDistancia(GrafoCSR grafo, const ConfiguracionVD& configuracion)
+    : g(move(grafo)), config(configuracion) {
+    n = g.cantidadNodos();
+    inf = config.infinito > 0 ? config.infinito : 16 * max(1, g.costoMaximo);
+    inf = min(inf, INT_MAX / 2); // inf + costo no desborda
+    config.maxRondas = min(config.maxRondas, (int)UINT16_MAX); // los contadores de subidas no se saturan
+    size_t celdas = (size_t)n * n;
+    for (int k = 0; k < 2; ++k) {
+        dist[k].assign(celdas, inf);
+        salto[k].assign(celdas, -1);
+    }
+    vigente.assign(n, 0);
+    subidas.resize(celdas);
+}
+
+int SimuladorVectorDistancia::costo(int enrutador, int destino) const {
+    int c = filaDist(enrutador)[destino];
+    return c >= inf ? INFINITO : c;
+}
+
+int SimuladorVectorDistancia::siguienteSalto(int enrutador, int destino) const {
+    return filaSalto(enrutador)[destino];
+}
+
+map<string, pair<int, string>> SimuladorVectorDistancia::tabla(int enrutador) const {
+    map<string, pair<int, string>> t;
+    for (int d = 0; d < n; ++d) {
+        int c = costo(enrutador, d);
+        if (c == INFINITO) continue;
+        t[g.nombre(d)] = {c, d == enrutador ? "-" : g.nombre(siguienteSalto(enrutador, d))};
+    }
+    return t;
+}
+
+// ============================
+// Núcleo SIMD: nd[d] = min(nd[d], min(c + dv[d], inf)), anotando v como salto
+// ============================
+// Con 'envenenar', los destinos que el vecino alcanza a través de 'yo'
+// (sv[d] == yo) se anuncian como inalcanzables.
+static inline void relajar(int* nd, int* ns, const int* dv, const int* sv,
+                           int c, int v, int yo, int inf, int n, bool envenenar) {
+    int d = 0;
+#if defined(__AVX2__)
+    __m256i vc = _mm256_set1_epi32(c), vinf = _mm256_set1_epi32(inf);
+    __m256i vv = _mm256_set1_epi32(v), vyo = _mm256_set1_epi32(yo);
+    for (; d + 8 <= n; d += 8) {
+        __m256i cand = _mm256_min_epi32(_mm256_add_epi32(vc, _mm256_loadu_si256((const __m256i*)(dv + d))), vinf);
+        if (envenenar) {
+            __m256i propio = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i*)(sv + d)), vyo);
+            cand = _mm256_blendv_epi8(cand, vinf, propio);
+        }
+        __m256i actual = _mm256_loadu_si256((const __m256i*)(nd + d));
+        __m256i mejor = _mm256_cmpgt_epi32(actual, cand);
+        _mm256_storeu_si256((__m256i*)(nd + d), _mm256_min_epi32(actual, cand));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(ns + d));
+        _mm256_storeu_si256((__m256i*)(ns + d), _mm256_blendv_epi8(s, vv, mejor));
+    }
+#elif defined(__SSE4_1__)
+    __m128i vc = _mm_set1_epi32(c), vinf = _mm_set1_epi32(inf);
+    __m128i vv = _mm_set1_epi32(v), vyo = _mm_set1_epi32(yo);
+    for (; d + 4 <= n; d += 4) {
+        __m128i cand = _mm_min_epi32(_mm_add_epi32(vc, _mm_loadu_si128((const __m128i*)(dv + d))), vinf);
+        if (envenenar) {
+            __m128i propio = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)(sv + d)), vyo);
+            cand = _mm_blendv_epi8(cand, vinf, propio);
+        }
+        __m128i actual = _mm_loadu_si128((const __m128i*)(nd + d));
+        __m128i mejor = _mm_cmpgt_epi32(actual, cand);
+        _mm_storeu_si128((__m128i*)(nd + d), _mm_min_epi32(actual, cand));
+        __m128i s = _mm_loadu_si128((const __m128i*)(ns + d));
+        _mm_storeu_si128((__m128i*)(ns + d), _mm_blendv_epi8(s, vv, mejor));
+    }
+#endif
+    for (; d < n; ++d) {
+        int candidato = (envenenar && sv[d] == yo) ? inf : min(c + dv[d], inf);
+        if (candidato < nd[d]) { nd[d] = candidato; ns[d] = v; }
+    }
+}
+
+// ============================
+// Una fila: mínimo sobre los vecinos de (costo del enlace + vector del vecino)
+// ============================
+void SimuladorVectorDistancia::recalcularFila(int i, int* nd, int* ns) const {
+    fill(nd, nd + n, inf);
+    fill(ns, ns + n, -1);
+
+    for (int e = g.inicio[i]; e < g.inicio[i + 1]; ++e) {
+        int v = g.destino[e];
+        int c = g.costo[e];
+        if (c >= inf) continue;
+        relajar(nd, ns, filaDist(v), filaSalto(v), c, v, i, inf, n, config.horizonteDividido);
+    }
+    nd[i] = 0;
+    ns[i] = i;
+}
+
+// ============================
+// Rondas síncronas
+// ============================
+InformeVD SimuladorVectorDistancia::ejecutarRondas(vector<int> pendientes, PoolHilos& pool) {
+    InformeVD informe;
+    auto t0 = chrono::steady_clock::now();
+    fill(subidas.begin(), subidas.end(), 0);
+
+    struct alignas(64) Contadores { long long cambiadas = 0; };
+    vector<Contadores> porHilo(pool.cantidadHilos());
+    vector<char> anuncia(n, 0), marca(n, 0);
+    vector<int> siguiente;
+
+    while (!pendientes.empty() && informe.rondas < config.maxRondas) {
+        ++informe.rondas;
+
+        // Cada fila se calcula con los vectores de la ronda anterior
+        pool.paraCada((int)pendientes.size(), [&](int k, int hilo) {
+            int i = pendientes[k];
+            size_t base = (size_t)i * n;
+            int otra = 1 - vigente[i];
+            int* nd = dist[otra].data() + base;
+            int* ns = salto[otra].data() + base;
+            recalcularFila(i, nd, ns);
+
+            const int* viejaD = filaDist(i);
+            const int* viejoS = filaSalto(i);
+            uint16_t* sub = subidas.data() + base;
+            long long cambiadas = 0;
+            bool cambioSalto = false;
+            // sin saltos: el resultado de cada comparación se suma directamente
+            for (int d = 0; d < n; ++d) {
+                int nuevo = nd[d], viejo = viejaD[d];
+                cambiadas += nuevo != viejo;
+                sub[d] += (nuevo > viejo) & (nuevo < inf);
+            }
+            if (config.horizonteDividido)
+                for (int d = 0; d < n && !cambioSalto; ++d) cambioSalto = ns[d] != viejoS[d];
+            porHilo[hilo].cambiadas += cambiadas;
+            anuncia[i] = cambiadas > 0 || (config.horizonteDividido && cambioSalto);
+        }, FILAS_POR_TAREA);
+
+        // Fin de la ronda: los vectores nuevos pasan a ser los anunciados
+        for (int i : pendientes) vigente[i] ^= 1;
+
+        // Quien cambió envía su vector a todos sus vecinos, que recalculan en la próxima ronda
+        siguiente.clear();
+        for (int i : pendientes) {
+            if (!anuncia[i]) continue;
+            anuncia[i] = 0;
+            informe.mensajes += g.inicio[i + 1] - g.inicio[i];
+            for (int e = g.inicio[i]; e < g.inicio[i + 1]; ++e) {
+                int v = g.destino[e];
+                if (!marca[v]) { marca[v] = 1; siguiente.push_back(v); }
+            }
+        }
+        for (int v : siguiente) marca[v] = 0;
+        pendientes.swap(siguiente);
+    }
+    informe.convergio = pendientes.empty();
+
+    for (auto& c : porHilo) informe.entradasCambiadas += c.cambiadas;
+    for (int i = 0; i < n; ++i) {
+        const int* fila = filaDist(i);
+        const uint16_t* sub = subidas.data() + (size_t)i * n;
+        for (int d = 0; d < n; ++d)
+            if (fila[d] >= inf && sub[d] >= 2) {
+                ++informe.cuentaAlInfinito;
+                informe.mayorCuenta = max(informe.mayorCuenta, (int)sub[d]);
+            }
+    }
+
+    informe.ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+    return informe;
+}
+
+InformeVD SimuladorVectorDistancia::converger(PoolHilos& pool) {
+    // Cada enrutador arranca sabiendo solo el costo hacia sus vecinos
+    vigente.assign(n, 0);
+    fill(dist[0].begin(), dist[0].end(), inf);
+    fill(salto[0].begin(), salto[0].end(), -1);
+    vector<int> pendientes;
+    long long anuncioInicial = 0;
+    for (int i = 0; i < n; ++i) {
+        int* d = dist[0].data() + (size_t)i * n;
+        int* s = salto[0].data() + (size_t)i * n;
+        d[i] = 0;
+        s[i] = i;
+        for (int e = g.inicio[i]; e < g.inicio[i + 1]; ++e) {
+            int v = g.destino[e];
+            if (g.costo[e] < d[v]) {
+                d[v] = min(g.costo[e], inf);
+                s[v] = v;
+            }
+        }
+        anuncioInicial += g.inicio[i + 1] - g.inicio[i];
+        if (g.inicio[i + 1] > g.inicio[i]) pendientes.push_back(i);
+    }
+
+    InformeVD informe = ejecutarRondas(move(pendientes), pool);
+    informe.mensajes += anuncioInicial;
+    return informe;
+}
+
+InformeVD SimuladorVectorDistancia::enlaceCambiado(GrafoCSR grafo, int u, int v, PoolHilos& pool) {
+    g = move(grafo);
+    // Solo los extremos del enlace lo notan; el resto se entera por los anuncios
+    return ejecutarRondas({u, v}, pool);
+}
+
+InformeVD SimuladorVectorDistancia::enlacesCambiados(GrafoCSR grafo, vector<int> extremos, PoolHilos& pool) {
+    g = move(grafo);
+    return ejecutarRondas(move(extremos), pool);
+}
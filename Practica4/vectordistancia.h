@@ -0,0 +1,86 @@
+#ifndef VECTORDISTANCIA_H
+#define VECTORDISTANCIA_H
+
+#include "grafocsr.h"
+#include "poolhilos.h"
+#include <vector>
+#include <map>
+#include <string>
+#include <cstdint>
+
+// ===========================
+// Simulación de vector distancia (RIP / Bellman-Ford distribuido)
+// ===========================
+// Cada enrutador guarda su propio vector (costo y siguiente salto hacia
+// cada destino) y solo conoce a sus vecinos. Las rondas son síncronas: en
+// la ronda r cada enrutador que recibió un vector nuevo en la ronda r - 1
+// recalcula su tabla como el mínimo, sobre sus vecinos, de costo del
+// enlace + vector anunciado por el vecino. Los enrutadores cuyo vector
+// cambió lo anuncian a todos sus vecinos (un mensaje por vecino). Las filas
+// de cada ronda se reparten en el pool de hilos.
+//
+// Como en RIP, los costos se saturan en 'infinito': un destino con costo
+// igual o mayor se considera inalcanzable. Eso acota la cuenta al infinito
+// que aparece al eliminar enlaces.
+
+// Las tablas ocupan unos 18 bytes por par (enrutador, destino)
+const int MAX_NODOS_VD = 10000;
+
+struct ConfiguracionVD {
+    int infinito = 0;               // 0 = 16 veces el costo máximo de la red (16 saltos en RIP)
+    bool horizonteDividido = false; // horizonte dividido con envenenamiento en reversa
+    int maxRondas = 10000;
+};
+
+struct InformeVD {
+    int rondas = 0;
+    bool convergio = false;
+    long long mensajes = 0;          // vectores enviados (uno por vecino)
+    long long entradasCambiadas = 0; // (enrutador, destino) actualizados
+    long long cuentaAlInfinito = 0;  // entradas que subieron varias rondas hasta quedar inalcanzables
+    int mayorCuenta = 0;             // rondas de subida de la peor de esas entradas
+    double ms = 0;
+};
+
+class SimuladorVectorDistancia {
+public:
+    SimuladorVectorDistancia(GrafoCSR grafo, const ConfiguracionVD& configuracion);
+
+    // Arranque en frío: cada enrutador conoce solo a sus vecinos
+    InformeVD converger(PoolHilos& pool);
+
+    // El enlace u - v cambió de costo o desapareció en 'grafo' (mismos
+    // enrutadores); se reconverge a partir de las tablas actuales
+    InformeVD enlaceCambiado(GrafoCSR grafo, int u, int v, PoolHilos& pool);
+
+    // Varios enlaces cambiaron a la vez (un lote); 'extremos' son los
+    // enrutadores que los notan, sin repetir
+    InformeVD enlacesCambiados(GrafoCSR grafo, std::vector<int> extremos, PoolHilos& pool);
+
+    int cantidadNodos() const { return n; }
+    int infinito() const { return inf; }
+    int costo(int enrutador, int destino) const;        // INFINITO si es inalcanzable
+    int siguienteSalto(int enrutador, int destino) const; // -1 si es inalcanzable
+
+    // Formato de Router::mostrarTablaEnrutamiento: destino -> (costo, siguiente salto)
+    std::map<std::string, std::pair<int, std::string>> tabla(int enrutador) const;
+
+private:
+    InformeVD ejecutarRondas(std::vector<int> pendientes, PoolHilos& pool);
+    void recalcularFila(int i, int* dist, int* salto) const;
+
+    // Fila vigente (la anunciada) de cada enrutador. La ronda en curso se
+    // escribe en la otra mitad y al cerrarla solo se cambia 'vigente'
+    const int* filaDist(int i) const { return dist[vigente[i]].data() + (size_t)i * n; }
+    const int* filaSalto(int i) const { return salto[vigente[i]].data() + (size_t)i * n; }
+
+    GrafoCSR g;
+    ConfiguracionVD config;
+    int n;
+    int inf;
+    std::vector<int> dist[2], salto[2];   // n x n cada una, fila = vector de cada enrutador
+    std::vector<uint8_t> vigente;         // mitad que tiene el vector anunciado de cada fila
+    std::vector<uint16_t> subidas;        // rondas en que subió cada entrada
+};
+
+#endif // VECTORDISTANCIA_H
@@ -0,0 +1,265 @@
+#include "red.h"
+#include "grafocsr.h"
+#include "cacherutas.h"
+#include "todospares.h"
+#include "versiones.h"
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+
+using namespace std;
+
+// Comprobaciones aleatorias de las partes que se actualizan de a poco:
+//  - la caché de rutas reparada tras cada edición (enlaces nuevos, costos
+//    que suben o bajan, enlaces y enrutadores quitados o agregados) contra
+//    el cálculo completo sobre la misma instantánea;
+//  - las versiones fijadas por lectores de otros hilos mientras la red se
+//    edita: cada una debe ser una instantánea entera y coherente.
+// Termina con 0 si no encontró diferencias.
+
+// ============================
+// Utilidades
+// ============================
+
+// Costo del enlace u - v en la instantánea (INFINITO si no hay)
+static int costoEnlace(const GrafoCSR& g, int u, int v) {
+    const int* fila = g.destino.begin() + g.inicio[u];
+    const int* fin = g.destino.begin() + g.inicio[u + 1];
+    const int* it = lower_bound(fila, fin, v);
+    return it != fin && *it == v ? g.costo[it - g.destino.begin()] : INFINITO;
+}
+
+// Filas ordenadas, vecinos en rango y cada enlace con su inverso del mismo costo
+static bool instantaneaCoherente(const GrafoCSR& g) {
+    int n = g.cantidadNodos();
+    if ((int)g.inicio.size() != n + 1 || g.inicio[0] != 0 || (size_t)g.inicio[n] != g.destino.size())
+        return false;
+    for (int i = 0; i < n; ++i) {
+        if (i > 0 && g.ids[i] <= g.ids[i - 1]) return false;
+        for (int e = g.inicio[i]; e < g.inicio[i + 1]; ++e) {
+            int v = g.destino[e];
+            if (v < 0 || v >= n || v == i || (e > g.inicio[i] && v <= g.destino[e - 1])) return false;
+            if (costoEnlace(g, v, i) != g.costo[e]) return false;
+        }
+    }
+    return true;
+}
+
+// Compara la caché con el cálculo completo: distancias iguales y cada
+// predecesor sobre un enlace que existe y cierra la distancia (con empates
+// los árboles pueden diferir, así que no se comparan los predecesores)
+static bool cacheCorrecta(const CacheRutas& cache, const GrafoCSR& g, PoolHilos& pool, string& detalle) {
+    MatrizTodosLosPares completa;
+    calcularTodosLosPares(g, pool, completa, false);
+    const MatrizTodosLosPares& m = cache.tablas();
+    int n = g.cantidadNodos();
+    if (m.n != n) {
+        detalle = "la caché tiene " + to_string(m.n) + " nodos y la red " + to_string(n);
+        return false;
+    }
+    for (int i = 0; i < n; ++i) {
+        const int* dist = m.filaDist(i);
+        const int* esperada = completa.filaDist(i);
+        for (int j = 0; j < n; ++j) {
+            if (dist[j] != esperada[j]) {
+                detalle = "distancia R" + to_string(g.ids[i]) + " -> R" + to_string(g.ids[j]) + ": " +
+                          to_string(dist[j]) + " en la caché, " + to_string(esperada[j]) + " recalculada";
+                return false;
+            }
+            if (j == i || dist[j] == INFINITO) continue;
+            int p = m.predecesor(i, j);
+            int c = p < 0 ? INFINITO : costoEnlace(g, p, j);
+            if (c == INFINITO || dist[p] == INFINITO || dist[p] + c != dist[j]) {
+                detalle = "predecesor inválido de R" + to_string(g.ids[j]) + " desde R" + to_string(g.ids[i]);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// ============================
+// Reparación frente a recálculo
+// ============================
+static bool verificarReparaciones(int casos, int pasos, int nodos, int hilos, uint64_t semilla) {
+    PoolHilos pool(hilos);
+    mt19937_64 gen(semilla);
+    auto azar = [&](int limite) { return (int)(gen() % (uint64_t)limite); };
+
+    for (int caso = 0; caso < casos; ++caso) {
+        int n = nodos / 2 + azar(nodos / 2 + 1);
+        Red red(n);
+        vector<int> vivos;
+        for (int id = 1; id <= n; ++id) vivos.push_back(id);
+        for (int k = 0; k < 2 * n; ++k) {
+            int a = vivos[azar(n)], b = vivos[azar(n)];
+            if (a != b) red.conectar(a, b, 1 + azar(20));
+        }
+
+        CacheRutas cache;
+        cache.recalcular(red.instantanea(), pool);
+
+        for (int paso = 0; paso < pasos; ++paso) {
+            GrafoCSR anterior = red.instantanea();
+            int a = vivos[azar((int)vivos.size())], b = vivos[azar((int)vivos.size())];
+            int tipo = azar(10);
+            string edicion;
+
+            if (tipo < 5 && a != b) {
+                // Enlace nuevo o cambio de costo (sube o baja)
+                int costoAnterior = costoEnlace(anterior, indiceDeId(anterior, a), indiceDeId(anterior, b));
+                int costo = 1 + azar(20);
+                red.conectar(a, b, costo);
+                const GrafoCSR& g = red.instantanea();
+                cache.enlaceCambiado(g, indiceDeId(g, a), indiceDeId(g, b), costoAnterior, costo, pool);
+                edicion = "conectar R" + to_string(a) + " - R" + to_string(b) + " con costo " + to_string(costo);
+            } else if (tipo < 8 && a != b) {
+                int costoAnterior = costoEnlace(anterior, indiceDeId(anterior, a), indiceDeId(anterior, b));
+                if (costoAnterior == INFINITO) continue;
+                red.desconectar(a, b);
+                const GrafoCSR& g = red.instantanea();
+                cache.enlaceCambiado(g, indiceDeId(g, a), indiceDeId(g, b), costoAnterior, INFINITO, pool);
+                edicion = "desconectar R" + to_string(a) + " - R" + to_string(b);
+            } else if (tipo == 8) {
+                int id = red.crearEnrutador();
+                vivos.push_back(id);
+                cache.enrutadorAgregado(red.instantanea());
+                edicion = "crear R" + to_string(id);
+            } else if (tipo == 9 && vivos.size() > 3) {
+                int indice = indiceDeId(anterior, a);
+                red.quitarEnrutador(a);
+                vivos.erase(find(vivos.begin(), vivos.end(), a));
+                cache.enrutadorEliminado(red.instantanea(), indice, pool);
+                edicion = "quitar R" + to_string(a);
+            } else {
+                continue;
+            }
+
+            string detalle;
+            if (!cacheCorrecta(cache, red.instantanea(), pool, detalle)) {
+                cerr << "Caso " << caso << ", paso " << paso << " (" << edicion << "): " << detalle << "\n";
+                return false;
+            }
+        }
+    }
+    cout << "Reparaciones: " << casos << " casos de " << pasos << " ediciones, iguales al recálculo.\n";
+    return true;
+}
+
+// ============================
+// Versiones con ediciones concurrentes
+// ============================
+static bool verificarVersiones(int nodos, int ediciones, int lectores, uint64_t semilla) {
+    Red red(nodos);
+    mt19937_64 gen(semilla);
+    for (int k = 0; k < 3 * nodos; ++k) {
+        int a = 1 + (int)(gen() % nodos), b = 1 + (int)(gen() % nodos);
+        if (a != b) red.conectar(a, b, 1 + (int)(gen() % 20));
+    }
+    red.fijarVersion();
+
+    atomic<bool> terminado{false};
+    atomic<long long> consultas{0}, fallas{0};
+    vector<thread> hilos;
+    for (int l = 0; l < lectores; ++l) {
+        hilos.emplace_back([&, l] {
+            mt19937_64 azar(semilla + 1 + l);
+            uint64_t ultimo = 0;
+            vector<int> camino, dist, prev;
+            while (!terminado.load(memory_order_acquire)) {
+                VersionFijada v = red.fijarVersion();
+                const GrafoCSR& g = v->grafo;
+                int n = g.cantidadNodos();
+                bool ok = v->numero >= ultimo && instantaneaCoherente(g);
+                ultimo = v->numero;
+                if (ok && n >= 2) {
+                    // Ruta sobre la versión fijada contra Dijkstra sobre la misma
+                    int o = (int)(azar() % n), d = (int)(azar() % n);
+                    int costo = rutaEnVersion(*v, g.ids[o], g.ids[d], camino);
+                    dijkstra(g, o, dist, prev);
+                    ok = costo == dist[d];
+                    int suma = 0;
+                    for (size_t k = 1; ok && costo != INFINITO && k < camino.size(); ++k) {
+                        int c = costoEnlace(g, v->indiceDe(camino[k - 1]), v->indiceDe(camino[k]));
+                        ok = c != INFINITO;
+                        suma += c;
+                    }
+                    if (ok && costo != INFINITO) ok = suma == costo;
+                }
+                if (!ok) ++fallas;
+                ++consultas;
+            }
+        });
+    }
+
+    // El escritor alterna ediciones sueltas y lotes
+    vector<int> vivos;
+    for (int id = 1; id <= nodos; ++id) vivos.push_back(id);
+    for (int k = 0; k < ediciones; ++k) {
+        int a = vivos[gen() % vivos.size()], b = vivos[gen() % vivos.size()];
+        switch (gen() % 6) {
+        case 0: case 1:
+            if (a != b) red.conectar(a, b, 1 + (int)(gen() % 20));
+            break;
+        case 2:
+            red.desconectar(a, b);
+            break;
+        case 3:
+            vivos.push_back(red.crearEnrutador());
+            break;
+        case 4:
+            if (vivos.size() > 3 && red.quitarEnrutador(a))
+                vivos.erase(find(vivos.begin(), vivos.end(), a));
+            break;
+        default: {
+            vector<Edicion> lote;
+            for (int j = 0; j < 8; ++j) {
+                int x = vivos[gen() % vivos.size()], y = vivos[gen() % vivos.size()];
+                if (x != y) lote.push_back({TipoEdicion::Conectar, x, y, 1 + (int)(gen() % 20)});
+            }
+            red.aplicarEdiciones(lote);
+        }
+        }
+        if (k % 16 == 0) this_thread::yield();
+    }
+    terminado = true;
+    for (thread& h : hilos) h.join();
+
+    if (fallas > 0) {
+        cerr << "Versiones: " << fallas << " de " << consultas << " lecturas con una instantánea incoherente.\n";
+        return false;
+    }
+    cout << "Versiones: " << consultas << " lecturas de " << lectores << " hilos durante "
+         << ediciones << " ediciones, todas coherentes.\n";
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    // Uso: verificacion [--casos C] [--pasos P] [--nodos N] [--hilos H]
+    //                   [--lectores L] [--semilla S]
+    int casos = 40, pasos = 60, nodos = 40, hilos = 0, lectores = 4;
+    uint64_t semilla = 1;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        string opcion = argv[i];
+        if (opcion == "--casos") casos = atoi(argv[i + 1]);
+        else if (opcion == "--pasos") pasos = atoi(argv[i + 1]);
+        else if (opcion == "--nodos") nodos = atoi(argv[i + 1]);
+        else if (opcion == "--hilos") hilos = atoi(argv[i + 1]);
+        else if (opcion == "--lectores") lectores = atoi(argv[i + 1]);
+        else if (opcion == "--semilla") semilla = strtoull(argv[i + 1], nullptr, 10);
+        else { cerr << "Opción desconocida: " << opcion << "\n"; return 1; }
+    }
+    if (casos < 1 || pasos < 1 || nodos < 4 || hilos < 0 || lectores < 1) {
+        cerr << "Parámetros inválidos.\n";
+        return 1;
+    }
+
+    bool ok = verificarReparaciones(casos, pasos, nodos, hilos, semilla);
+    ok = verificarVersiones(nodos * 10, casos * pasos, lectores, semilla) && ok;
+    return ok ? 0 : 1;
+}
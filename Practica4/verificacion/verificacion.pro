@@ -0,0 +1,53 @@
+TEMPLATE = app
+TARGET = verificacion
+CONFIG += console c++17
+CONFIG -= app_bundle
+CONFIG -= qt
+CONFIG += thread
+
+INCLUDEPATH += ..
+
+SOURCES += \
+        main.cpp \
+        ../enrutador.cpp \
+        ../red.cpp \
+        ../grafocsr.cpp \
+        ../poolhilos.cpp \
+        ../todospares.cpp \
+        ../floydwarshall.cpp \
+        ../cacherutas.cpp \
+        ../bidireccional.cpp \
+        ../formatobinario.cpp \
+        ../cargadortexto.cpp \
+        ../generadores.cpp \
+        ../vectordistancia.cpp \
+        ../colacalendario.cpp \
+        ../estadoenlace.cpp \
+        ../reenvio.cpp \
+        ../exportacion.cpp \
+        ../instrumentacion.cpp \
+        ../versiones.cpp \
+        ../jerarquia.cpp \
+        ../matrizcostos.cpp
+
+HEADERS += \
+    ../enrutador.h \
+    ../red.h \
+    ../grafocsr.h \
+    ../poolhilos.h \
+    ../todospares.h \
+    ../floydwarshall.h \
+    ../cacherutas.h \
+    ../bidireccional.h \
+    ../formatobinario.h \
+    ../cargadortexto.h \
+    ../generadores.h \
+    ../vectordistancia.h \
+    ../colacalendario.h \
+    ../estadoenlace.h \
+    ../reenvio.h \
+    ../exportacion.h \
+    ../instrumentacion.h \
+    ../versiones.h \
+    ../jerarquia.h \
+    ../matrizcostos.h
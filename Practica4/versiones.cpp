@@ -0,0 +1,43 @@
+#include "versiones.h"
+#include "bidireccional.h"
+#include <algorithm>
+using namespace std;
+
+int VersionRed::indiceDe(int id) const {
+    return indiceDeId(grafo, id);
+}
+
+// ============================
+// Publicación
+// ============================
+PublicadorVersiones::PublicadorVersiones() : actual(make_shared<const VersionRed>()) {}
+
+VersionFijada PublicadorVersiones::fijar() const {
+    return atomic_load(&actual);
+}
+
+void PublicadorVersiones::publicar(GrafoCSR grafo) {
+    auto nueva = make_shared<VersionRed>();
+    nueva->numero = ultimo.load(memory_order_relaxed) + 1;
+    nueva->grafo = move(grafo);
+    uint64_t numeroNuevo = nueva->numero;
+    // La versión anterior queda viva mientras algún lector la tenga fijada
+    atomic_store(&actual, shared_ptr<const VersionRed>(move(nueva)));
+    ultimo.store(numeroNuevo, memory_order_release);
+}
+
+// ============================
+// Consultas de lectores
+// ============================
+int rutaEnVersion(const VersionRed& version, int origenId, int destinoId, vector<int>& caminoIds) {
+    thread_local EspacioBidireccional espacio;
+    thread_local vector<int> camino;
+
+    caminoIds.clear();
+    int o = version.indiceDe(origenId), d = version.indiceDe(destinoId);
+    if (o < 0 || d < 0) return INFINITO;
+
+    int costo = rutaBidireccional(version.grafo, o, d, camino, espacio);
+    for (int x : camino) caminoIds.push_back(version.grafo.ids[x]);
+    return costo;
+}
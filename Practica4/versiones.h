@@ -0,0 +1,54 @@
+#ifndef VERSIONES_H
+#define VERSIONES_H
+
+#include "grafocsr.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// ===========================
+// Versiones publicadas de la topología
+// ===========================
+// Cada versión es una instantánea CSR inmutable con un número creciente.
+// La versión vigente se publica con un intercambio atómico de shared_ptr:
+// un lector la fija copiando el puntero (un incremento de la cuenta de
+// referencias) y puede consultarla todo lo que quiera aunque mientras
+// tanto se publiquen otras. La memoria de una versión se libera cuando la
+// suelta su último lector, sin que el escritor espere a nadie.
+//
+// Los índices y los ids de una versión no cambian aunque la red se edite
+// después (p. ej. al eliminar un enrutador, que corre los índices de los
+// posteriores aunque sus ids se mantengan).
+struct VersionRed {
+    uint64_t numero = 0;
+    GrafoCSR grafo;
+
+    int indiceDe(int id) const;   // -1 si el id no existe en esta versión
+};
+
+using VersionFijada = std::shared_ptr<const VersionRed>;
+
+class PublicadorVersiones {
+public:
+    PublicadorVersiones();
+
+    VersionFijada fijar() const;                  // desde cualquier hilo
+    uint64_t numero() const { return ultimo.load(std::memory_order_acquire); }
+
+    // Publica 'grafo' como la versión siguiente. Las publicaciones deben
+    // estar serializadas por el llamador (un solo escritor a la vez)
+    void publicar(GrafoCSR grafo);
+
+private:
+    std::shared_ptr<const VersionRed> actual;     // se lee y escribe con atomic_load/atomic_store
+    std::atomic<uint64_t> ultimo{0};
+};
+
+// Ruta más corta entre dos ids sobre una versión fijada, con memoria de
+// trabajo propia de cada hilo: se puede llamar desde varios hilos a la vez.
+// Devuelve el costo (INFINITO si no hay ruta o algún id no existe) y deja
+// los ids del camino en 'caminoIds'.
+int rutaEnVersion(const VersionRed& version, int origenId, int destinoId, std::vector<int>& caminoIds);
+
+#endif // VERSIONES_H